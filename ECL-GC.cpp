@@ -0,0 +1,875 @@
+#include <algorithm>
+#include <vector>
+#include "ECL-GC.h"
+
+#include <omp.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+
+static const int BPI = 32;  // bits per int
+static const int MSB = 1 << (BPI - 1);
+static const int Mask = (1 << (BPI / 2)) - 1;
+static_assert(BPI == sizeof(int) * 8, "bits per int must match the size of int");
+
+
+// source of hash function: https://stackoverflow.com/questions/664014/what-integer-hash-function-are-good-that-accepts-an-integer-hash-key
+static unsigned int hash(unsigned int val)
+{
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+
+#ifdef ECL_STATS
+// per-thread hot-path counters, only compiled in with -DECL_STATS and merged by printColoringStats
+struct alignas(64) ThreadStats
+{
+  std::vector<long long> active[2];  // worklist size in each round of runLarge and runSmall (recorded by thread 0)
+  long long updates;  // atomic posscol2 updates in runLarge
+  long long scans;  // posscol2 words scanned for the lowest possible color in runLarge
+  long long shortcuts[2];  // vertices decided through the shortcut test in runLarge and runSmall
+  long long done;  // runLarge vertices decided because all higher-priority neighbors were done
+};
+
+static std::vector<ThreadStats> threadstats;
+
+static ThreadStats& threadStats() {return threadstats[omp_get_thread_num()];}
+
+static void resetStats(const int threads)
+{
+  threadstats.assign(threads, ThreadStats());
+  for (int t = 0; t < threads; t++) {
+    threadstats[t].updates = threadstats[t].scans = threadstats[t].done = 0;
+    threadstats[t].shortcuts[0] = threadstats[t].shortcuts[1] = 0;
+  }
+}
+
+static void recordRound(const int phase, const long long items) {threadstats[0].active[phase].push_back(items);}
+
+void printColoringStats()
+{
+  const char* const name[2] = {"runLarge", "runSmall"};
+  for (int k = 0; k < 2; k++) {
+    std::vector<long long> active;
+    long long shortcuts = 0;
+    for (size_t t = 0; t < threadstats.size(); t++) {
+      const std::vector<long long>& a = threadstats[t].active[k];
+      if (a.size() > active.size()) active.resize(a.size(), 0);
+      for (size_t r = 0; r < a.size(); r++) active[r] += a[r];
+      shortcuts += threadstats[t].shortcuts[k];
+    }
+    printf("stats %s: %d rounds, %lld shortcut hits, active vertices per round:", name[k], (int)active.size(), shortcuts);
+    const size_t show = 64;  // keep the line readable for graphs that need thousands of rounds
+    for (size_t r = 0; r < std::min(active.size(), show); r++) printf(" %lld", active[r]);
+    if (active.size() > show) printf(" ... %lld", active.back());
+    printf("\n");
+  }
+  long long updates = 0, scans = 0, done = 0;
+  for (size_t t = 0; t < threadstats.size(); t++) {
+    updates += threadstats[t].updates;
+    scans += threadstats[t].scans;
+    done += threadstats[t].done;
+  }
+  printf("stats runLarge: %lld posscol2 updates, %lld posscol2 words scanned, %lld decided with all neighbors done\n", updates, scans, done);
+}
+#endif
+
+
+// neighbor scans of init and runLarge: a scalar reference plus AVX2 and AVX-512 versions with identical results,
+// selected at run time (the vector versions only exist on x86-64)
+
+// init: counts the neighbors in [from, end) that are colored before v; they are compacted into out if it is
+// not NULL and otherwise marked in active (bit MSB >> (i - beg) for position i)
+static inline int initScanScalar(const int v, const int degv, const ECLedge beg, const ECLedge from, const ECLedge end, const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ out, int& active)
+{
+  int cnt = 0;
+  for (ECLedge i = from; i < end; i++) {
+    const int nei = nlist[i];
+    const int degn = nidx[nei + 1] - nidx[nei];
+    if ((degv < degn) || ((degv == degn) && (hash(v) < hash(nei))) || ((degv == degn) && (hash(v) == hash(nei)) && (v < nei))) {
+      if (out != NULL) {
+        out[cnt] = nei;
+      } else {
+        active |= (unsigned int)MSB >> (i - beg);
+      }
+      cnt++;
+    }
+  }
+  return cnt;
+}
+
+// runLarge: clears the colors of decided neighbors in pcol (colors below BPI) or posscol2 (colors in
+// [mincol, maxcol)) and tracks whether all neighbors are decided and whether the shortcut still holds;
+// returns the number of posscol2 updates
+static inline int largeScanScalar(const int* const __restrict__ nlist, const ECLedge from, const ECLedge end, volatile int* const __restrict__ color, volatile int* const __restrict__ posscol2, const ECLedge offs, const int mincol, const int maxcol, int& pcol, bool& done, bool& shortcut)
+{
+  int updates = 0;
+  for (ECLedge i = from; i < end; i++) {
+    const int nei = nlist[i];
+    int neidata;  // const
+    #pragma omp atomic read
+    neidata = color[nei];
+    const int neirange = neidata >> (BPI / 2);
+    if (neirange == 0) {
+      const int neicol = neidata;
+      if (neicol < BPI) {
+        pcol &= ~((unsigned int)MSB >> neicol);
+      } else {
+        if ((mincol <= neicol) && (neicol < maxcol)) {
+          int pc;  // const
+          #pragma omp atomic read
+          pc = posscol2[offs + neicol / BPI];
+          if ((pc << (neicol % BPI)) < 0) {
+            #pragma omp atomic update
+            posscol2[offs + neicol / BPI] &= ~((unsigned int)MSB >> (neicol % BPI));
+            updates++;
+          }
+        }
+      }
+    } else {
+      done = false;
+      const int neimincol = neidata & Mask;
+      const int neimaxcol = neimincol + neirange;
+      if ((neimincol <= mincol) && (neimaxcol >= mincol)) shortcut = false;
+    }
+  }
+  return updates;
+}
+
+
+#ifdef __x86_64__
+// the degree of nei is read from the low words of nidx[nei] and nidx[nei + 1], which are at int index
+// nei << OffsetShift (little endian); the difference of the low words is exact because degrees fit in an int
+static const int OffsetShift = (sizeof(ECLedge) == sizeof(long long)) ? 1 : 0;
+
+// lane order of the selected elements for every 8-bit mask, used to emulate a compress-store with AVX2
+struct CompressTable
+{
+  int idx[256][8];
+  constexpr CompressTable() : idx()
+  {
+    for (int m = 0; m < 256; m++) {
+      int k = 0;
+      for (int j = 0; j < 8; j++) {
+        if (m & (1 << j)) idx[m][k++] = j;
+      }
+      for (; k < 8; k++) idx[m][k] = 0;
+    }
+  }
+};
+static constexpr CompressTable compress8;
+
+__attribute__((target("avx2")))
+static inline __m256i hashAVX2(__m256i val)
+{
+  const __m256i mul = _mm256_set1_epi32(0x45d9f3b);
+  val = _mm256_mullo_epi32(_mm256_xor_si256(_mm256_srli_epi32(val, 16), val), mul);
+  val = _mm256_mullo_epi32(_mm256_xor_si256(_mm256_srli_epi32(val, 16), val), mul);
+  return _mm256_xor_si256(_mm256_srli_epi32(val, 16), val);
+}
+
+__attribute__((target("avx2")))
+static int initScanAVX2(const int v, const int degv, const ECLedge beg, const ECLedge end, const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ out, int& active)
+{
+  const __m256i sign = _mm256_set1_epi32(MSB);  // flips the hashes so that signed compares order them unsigned
+  const __m256i vid = _mm256_set1_epi32(v);
+  const __m256i vdeg = _mm256_set1_epi32(degv);
+  const __m256i vhash = _mm256_set1_epi32(hash(v) ^ MSB);
+  const int* const lo = (const int*)nidx;
+  const int* const hi = lo + (1 << OffsetShift);
+  int cnt = 0;
+  ECLedge i = beg;
+  for (; i + 8 <= end; i += 8) {
+    const __m256i nei = _mm256_loadu_si256((const __m256i*)&nlist[i]);
+    const __m256i idx = _mm256_slli_epi32(nei, OffsetShift);
+    const __m256i degn = _mm256_sub_epi32(_mm256_i32gather_epi32(hi, idx, 4), _mm256_i32gather_epi32(lo, idx, 4));
+    const __m256i nhash = _mm256_xor_si256(hashAVX2(nei), sign);
+    const __m256i deq = _mm256_cmpeq_epi32(degn, vdeg);
+    const __m256i tie = _mm256_or_si256(_mm256_cmpgt_epi32(nhash, vhash), _mm256_and_si256(_mm256_cmpeq_epi32(nhash, vhash), _mm256_cmpgt_epi32(nei, vid)));
+    const __m256i sel = _mm256_or_si256(_mm256_cmpgt_epi32(degn, vdeg), _mm256_and_si256(deq, tie));
+    int m = _mm256_movemask_ps(_mm256_castsi256_ps(sel));
+    if (out != NULL) {
+      // stores 8 lanes, the ones past the selected neighbors land in [out + cnt, &nlist2[i + 8]) and get overwritten or ignored
+      const __m256i perm = _mm256_loadu_si256((const __m256i*)compress8.idx[m]);
+      _mm256_storeu_si256((__m256i*)&out[cnt], _mm256_permutevar8x32_epi32(nei, perm));
+    } else {
+      for (int b = m; b != 0; b &= b - 1) active |= (unsigned int)MSB >> (i - beg + __builtin_ctz(b));
+    }
+    cnt += __builtin_popcount(m);
+  }
+  return cnt + initScanScalar(v, degv, beg, i, end, nidx, nlist, (out != NULL) ? &out[cnt] : NULL, active);
+}
+
+__attribute__((target("avx2")))
+static int largeScanAVX2(const int* const __restrict__ nlist, const ECLedge beg, const ECLedge end, volatile int* const __restrict__ color, volatile int* const __restrict__ posscol2, const ECLedge offs, const int mincol, const int maxcol, int& pcol, bool& done, bool& shortcut)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i bpi = _mm256_set1_epi32(BPI);
+  const __m256i vmin = _mm256_set1_epi32(mincol);
+  const __m256i vmax = _mm256_set1_epi32(maxcol);
+  const __m256i msb = _mm256_set1_epi32(MSB);
+  const __m256i mask = _mm256_set1_epi32(Mask);
+  __m256i clear = zero;  // bits of the decided neighbor colors below BPI
+  __m256i busy = zero;  // lanes that saw an undecided neighbor
+  __m256i block = zero;  // lanes that saw an undecided neighbor whose range covers mincol
+  int updates = 0;
+  ECLedge i = beg;
+  for (; i + 8 <= end; i += 8) {
+    const __m256i nei = _mm256_loadu_si256((const __m256i*)&nlist[i]);
+    const __m256i data = _mm256_i32gather_epi32((const int*)color, nei, 4);
+    const __m256i range = _mm256_srli_epi32(data, BPI / 2);
+    const __m256i dec = _mm256_cmpeq_epi32(range, zero);
+    const __m256i low = _mm256_and_si256(dec, _mm256_cmpgt_epi32(bpi, data));
+    clear = _mm256_or_si256(clear, _mm256_and_si256(low, _mm256_srlv_epi32(msb, data)));
+    const __m256i und = _mm256_andnot_si256(dec, _mm256_set1_epi32(-1));
+    busy = _mm256_or_si256(busy, und);
+    const __m256i neimin = _mm256_and_si256(data, mask);
+    const __m256i cover = _mm256_andnot_si256(_mm256_cmpgt_epi32(neimin, vmin), _mm256_andnot_si256(_mm256_cmpgt_epi32(vmin, _mm256_add_epi32(neimin, range)), und));
+    block = _mm256_or_si256(block, cover);
+    const __m256i high = _mm256_andnot_si256(low, _mm256_and_si256(dec, _mm256_andnot_si256(_mm256_cmpgt_epi32(vmin, data), _mm256_cmpgt_epi32(vmax, data))));
+    const int m = _mm256_movemask_ps(_mm256_castsi256_ps(high));
+    if (m != 0) {
+      int cols[8];
+      _mm256_storeu_si256((__m256i*)cols, data);
+      for (int b = m; b != 0; b &= b - 1) {
+        const int neicol = cols[__builtin_ctz(b)];
+        int pc;  // const
+        #pragma omp atomic read
+        pc = posscol2[offs + neicol / BPI];
+        if ((pc << (neicol % BPI)) < 0) {
+          #pragma omp atomic update
+          posscol2[offs + neicol / BPI] &= ~((unsigned int)MSB >> (neicol % BPI));
+          updates++;
+        }
+      }
+    }
+  }
+  __m128i c = _mm_or_si128(_mm256_castsi256_si128(clear), _mm256_extracti128_si256(clear, 1));
+  c = _mm_or_si128(c, _mm_shuffle_epi32(c, 0x4e));
+  c = _mm_or_si128(c, _mm_shuffle_epi32(c, 0xb1));
+  pcol &= ~_mm_cvtsi128_si32(c);
+  if (!_mm256_testz_si256(busy, busy)) done = false;
+  if (!_mm256_testz_si256(block, block)) shortcut = false;
+  return updates + largeScanScalar(nlist, i, end, color, posscol2, offs, mincol, maxcol, pcol, done, shortcut);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i hashAVX512(__m512i val)
+{
+  const __m512i mul = _mm512_set1_epi32(0x45d9f3b);
+  val = _mm512_mullo_epi32(_mm512_xor_si512(_mm512_maskz_srli_epi32(0xffff, val, 16), val), mul);
+  val = _mm512_mullo_epi32(_mm512_xor_si512(_mm512_maskz_srli_epi32(0xffff, val, 16), val), mul);
+  return _mm512_xor_si512(_mm512_maskz_srli_epi32(0xffff, val, 16), val);
+}
+
+__attribute__((target("avx512f")))
+static int initScanAVX512(const int v, const int degv, const ECLedge beg, const ECLedge end, const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ out, int& active)
+{
+  const __m512i vid = _mm512_set1_epi32(v);
+  const __m512i vdeg = _mm512_set1_epi32(degv);
+  const __m512i vhash = _mm512_set1_epi32(hash(v));
+  const int* const lo = (const int*)nidx;
+  const int* const hi = lo + (1 << OffsetShift);
+  int cnt = 0;
+  for (ECLedge i = beg; i < end; i += 16) {
+    const __mmask16 lanes = (end - i >= 16) ? 0xffff : ((1 << (end - i)) - 1);
+    const __m512i nei = _mm512_maskz_loadu_epi32(lanes, &nlist[i]);
+    const __m512i idx = _mm512_maskz_slli_epi32(0xffff, nei, OffsetShift);
+    const __m512i degn = _mm512_sub_epi32(_mm512_mask_i32gather_epi32(vdeg, lanes, idx, hi, 4), _mm512_mask_i32gather_epi32(vdeg, lanes, idx, lo, 4));
+    const __m512i nhash = hashAVX512(nei);
+    const __mmask16 deq = _mm512_cmpeq_epi32_mask(degn, vdeg);
+    const __mmask16 tie = _mm512_cmpgt_epu32_mask(nhash, vhash) | (_mm512_cmpeq_epi32_mask(nhash, vhash) & _mm512_cmpgt_epi32_mask(nei, vid));
+    const __mmask16 m = lanes & (_mm512_cmpgt_epi32_mask(degn, vdeg) | (deq & tie));
+    if (out != NULL) {
+      _mm512_mask_compressstoreu_epi32(&out[cnt], m, nei);
+    } else {
+      for (int b = m; b != 0; b &= b - 1) active |= (unsigned int)MSB >> (i - beg + __builtin_ctz(b));
+    }
+    cnt += __builtin_popcount(m);
+  }
+  return cnt;
+}
+
+__attribute__((target("avx512f")))
+static int largeScanAVX512(const int* const __restrict__ nlist, const ECLedge beg, const ECLedge end, volatile int* const __restrict__ color, volatile int* const __restrict__ posscol2, const ECLedge offs, const int mincol, const int maxcol, int& pcol, bool& done, bool& shortcut)
+{
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i bpi = _mm512_set1_epi32(BPI);
+  const __m512i vmin = _mm512_set1_epi32(mincol);
+  const __m512i vmax = _mm512_set1_epi32(maxcol);
+  const __m512i msb = _mm512_set1_epi32(MSB);
+  const __m512i mask = _mm512_set1_epi32(Mask);
+  __m512i clear = zero;  // bits of the decided neighbor colors below BPI
+  __mmask16 busy = 0;  // lanes that saw an undecided neighbor
+  __mmask16 block = 0;  // lanes that saw an undecided neighbor whose range covers mincol
+  int updates = 0;
+  for (ECLedge i = beg; i < end; i += 16) {
+    const __mmask16 lanes = (end - i >= 16) ? 0xffff : ((1 << (end - i)) - 1);
+    const __m512i nei = _mm512_maskz_loadu_epi32(lanes, &nlist[i]);
+    const __m512i data = _mm512_mask_i32gather_epi32(zero, lanes, nei, (const int*)color, 4);
+    const __m512i range = _mm512_maskz_srli_epi32(0xffff, data, BPI / 2);
+    const __mmask16 dec = lanes & _mm512_cmpeq_epi32_mask(range, zero);
+    const __mmask16 low = dec & _mm512_cmplt_epi32_mask(data, bpi);
+    clear = _mm512_mask_or_epi32(clear, low, clear, _mm512_maskz_srlv_epi32(0xffff, msb, data));
+    const __mmask16 und = lanes & ~dec;
+    busy |= und;
+    const __m512i neimin = _mm512_and_si512(data, mask);
+    block |= und & _mm512_cmple_epi32_mask(neimin, vmin) & _mm512_cmpge_epi32_mask(_mm512_add_epi32(neimin, range), vmin);
+    const __mmask16 high = dec & ~low & _mm512_cmpge_epi32_mask(data, vmin) & _mm512_cmplt_epi32_mask(data, vmax);
+    if (high != 0) {
+      int cols[16];
+      _mm512_storeu_si512(cols, data);
+      for (int b = high; b != 0; b &= b - 1) {
+        const int neicol = cols[__builtin_ctz(b)];
+        int pc;  // const
+        #pragma omp atomic read
+        pc = posscol2[offs + neicol / BPI];
+        if ((pc << (neicol % BPI)) < 0) {
+          #pragma omp atomic update
+          posscol2[offs + neicol / BPI] &= ~((unsigned int)MSB >> (neicol % BPI));
+          updates++;
+        }
+      }
+    }
+  }
+  int bits[16];
+  _mm512_storeu_si512(bits, clear);
+  for (int j = 0; j < 16; j++) pcol &= ~bits[j];
+  if (busy != 0) done = false;
+  if (block != 0) shortcut = false;
+  return updates;
+}
+#endif
+
+
+// picks the widest supported kernel for vertices with at least one full vector of neighbors
+static inline int initScan(const int simd, const int v, const int degv, const ECLedge beg, const ECLedge end, const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ out, int& active)
+{
+#ifdef __x86_64__
+  if ((simd == ECL_SIMD_AVX512) && (degv >= 16)) return initScanAVX512(v, degv, beg, end, nidx, nlist, out, active);
+  if ((simd >= ECL_SIMD_AVX2) && (degv >= 8)) return initScanAVX2(v, degv, beg, end, nidx, nlist, out, active);
+#endif
+  return initScanScalar(v, degv, beg, beg, end, nidx, nlist, out, active);
+}
+
+static inline int largeScan(const int simd, const int* const __restrict__ nlist, const ECLedge beg, const ECLedge end, volatile int* const __restrict__ color, volatile int* const __restrict__ posscol2, const ECLedge offs, const int mincol, const int maxcol, int& pcol, bool& done, bool& shortcut)
+{
+#ifdef __x86_64__
+  if ((simd == ECL_SIMD_AVX512) && (end - beg >= 16)) return largeScanAVX512(nlist, beg, end, color, posscol2, offs, mincol, maxcol, pcol, done, shortcut);
+  if ((simd >= ECL_SIMD_AVX2) && (end - beg >= 8)) return largeScanAVX2(nlist, beg, end, color, posscol2, offs, mincol, maxcol, pcol, done, shortcut);
+#endif
+  return largeScanScalar(nlist, beg, end, color, posscol2, offs, mincol, maxcol, pcol, done, shortcut);
+}
+
+int simdLevel(const int requested)
+{
+  int best = ECL_SIMD_SCALAR;
+#ifdef __x86_64__
+  if (__builtin_cpu_supports("avx2")) best = ECL_SIMD_AVX2;
+  if (__builtin_cpu_supports("avx512f")) best = ECL_SIMD_AVX512;
+#endif
+  if (requested == ECL_SIMD_AUTO) return best;
+  if (requested > best) {fprintf(stderr, "ERROR: %s kernels are not supported on this CPU\n\n", simdname[requested]);  exit(-1);}
+  return requested;
+}
+
+
+static int init(const int nodes, const ECLedge edges, const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ nlist2, int* const __restrict__ posscol, int* const __restrict__ posscol2, int* const __restrict__ color, int* const __restrict__ wl, const int threads, const int simd)
+{
+  int wlsize = 0;
+  int maxrange = -1;
+  #pragma omp parallel for num_threads(threads) default(none) reduction(max: maxrange) shared(nodes, wlsize, wl, nidx, nlist, nlist2, color, posscol, simd) schedule(static)
+  for (int v = 0; v < nodes; v++) {
+    int active = 0;
+    const ECLedge beg = nidx[v];
+    const ECLedge end = nidx[v + 1];
+    const int degv = end - beg;
+    const bool cond = (degv >= BPI);
+    if (cond) {
+      int tmp;
+      #pragma omp atomic capture
+      tmp = wlsize++;
+      wl[tmp] = v;
+    }
+    const int range = initScan(simd, v, degv, beg, end, nidx, nlist, cond ? &nlist2[beg] : NULL, active);
+    maxrange = std::max(maxrange, range);  // reduction
+    color[v] = (cond || (range == 0)) ? (range << (BPI / 2)) : active;
+    posscol[v] = (range >= BPI) ? -1 : (MSB >> range);
+  }
+  if (maxrange >= Mask) {printf("too many active neighbors\n"); exit(-1);}
+  #pragma omp parallel for num_threads(threads) default(none) shared(edges, posscol2)
+  for (ECLedge i = 0; i < edges / BPI + 1; i++) posscol2[i] = -1;
+  return wlsize;
+}
+
+
+// processes rounds over a compacted, double-buffered worklist: every round calls process(v) for the vertices
+// that are still undecided (process returned true in the previous round) and costs time proportional to them;
+// the first round covers wl[0..size) or, if all is set, the vertices 0..size-1 (wl is then only scratch space);
+// survivors are compacted per block in place and concatenated into the other buffer using a prefix sum;
+// with local set, thread t always gets the t-th eighth of the blocks (the static vertex partition) instead
+template <typename F>
+static void runWorklist(int* const wl, const int size, int* const wl2, int* const cnt, const bool all, const bool local, const int threads, const int phase, F process)
+{
+  const int blocks = threads * 8;  // cnt holds blocks + 1 entries
+  int* in = wl;
+  int* out = wl2;
+  int items = size;
+  bool ident = all;
+  STAT(recordRound(phase, items));
+  #pragma omp parallel num_threads(threads) default(none) shared(in, out, items, ident, blocks, cnt, process, phase, local)
+  while (items > 0) {
+    const auto block = [&](const int b) {
+      const int beg = (long long)items * b / blocks;
+      const int end = (long long)items * (b + 1) / blocks;
+      int k = beg;
+      for (int w = beg; w < end; w++) {
+        const int v = ident ? w : in[w];
+        if (process(v)) in[k++] = v;
+      }
+      cnt[b + 1] = k - beg;
+    };
+    if (local) {
+      #pragma omp for schedule(static, 8)
+      for (int b = 0; b < blocks; b++) block(b);
+    } else {
+      #pragma omp for schedule(dynamic, 1)
+      for (int b = 0; b < blocks; b++) block(b);
+    }
+    #pragma omp single
+    {
+      cnt[0] = 0;
+      for (int b = 0; b < blocks; b++) cnt[b + 1] += cnt[b];
+    }
+    #pragma omp for schedule(dynamic, 1)
+    for (int b = 0; b < blocks; b++) {
+      const int beg = (long long)items * b / blocks;
+      std::copy(&in[beg], &in[beg + (cnt[b + 1] - cnt[b])], &out[cnt[b]]);
+    }
+    #pragma omp single
+    {
+      std::swap(in, out);
+      items = cnt[blocks];
+      ident = false;
+      STAT(if (items > 0) recordRound(phase, items));
+    }
+  }
+}
+
+
+// runLarge splits the neighbor scan of vertices with more than Grain candidate neighbors into chunks of Grain
+static const int Grain = 1024;
+
+// picks the lowest possible color of v once all candidate neighbors have been scanned and either decides v
+// or narrows its range; returns whether v is still undecided
+static inline bool finishLarge(const int v, int pcol, const bool done, bool shortcut, const int mincol, const int maxcol, const ECLedge offs, int* const __restrict__ posscol, volatile int* const __restrict__ posscol2, volatile int* const __restrict__ color)
+{
+  STAT(ThreadStats& st = threadStats());
+  int val = pcol;
+  int mc = 0;
+  if (pcol == 0) {
+    mc = std::max(1, mincol / BPI) - 1;
+    do {
+      mc++;
+      STAT(st.scans++);
+      #pragma omp atomic read
+      val = posscol2[offs + mc];
+    } while (val == 0);
+  }
+  int newmincol = mc * BPI + __builtin_clz(val);
+  if (mincol != newmincol) shortcut = false;
+  bool again = false;
+  if (shortcut || done) {
+    STAT(if (shortcut) st.shortcuts[0]++; else st.done++);
+    pcol = (newmincol < BPI) ? ((unsigned int)MSB >> newmincol) : 0;
+  } else {
+    const int range = maxcol - newmincol;
+    newmincol = (range << (BPI / 2)) | newmincol;
+    again = true;
+  }
+  posscol[v] = pcol;
+  #pragma omp atomic write
+  color[v] = newmincol;
+  return again;
+}
+
+// worklist slot of task x (the last slot k with first[k] <= x), searched forward from the slot of the
+// previous task of the same queue before falling back to a binary search
+static inline int taskSlot(const int* const first, const int items, const int x, int k)
+{
+  if ((k >= 0) && (first[k] <= x)) {
+    for (int j = 0; (j < 8) && (k < items); j++, k++) {
+      if (x < first[k + 1]) return k;
+    }
+  }
+  return std::upper_bound(first, first + items + 1, x) - first - 1;
+}
+
+// every round turns the undecided vertices into tasks (one per vertex, or one per Grain neighbors for hubs),
+// hands each thread a contiguous range of them and lets threads that run out steal single tasks from the
+// others through the queues' atomic counters; the chunks of a split vertex AND their partial pcol and
+// done/shortcut results into its slot of split (posscol2 is cleared atomically anyway), and whichever chunk
+// finishes last completes the vertex; survivors are appended to the other worklist buffer
+static void runLarge(const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ posscol, volatile int* const __restrict__ posscol2, volatile int* const __restrict__ color, int* const __restrict__ wl, int* const __restrict__ wl2, int* const __restrict__ first, int* const __restrict__ split, int* const __restrict__ cnt, const int wlsize, const int threads, const int simd)
+{
+  int* in = wl;
+  int* out = wl2;
+  int items = wlsize;
+  int survivors = 0;
+  STAT(recordRound(0, items));
+  #pragma omp parallel num_threads(threads) default(none) shared(nidx, nlist, posscol, posscol2, color, first, split, cnt, simd, in, out, items, survivors)
+  {
+    const int tid = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    int* const queue = &cnt[tid * 16];  // next task, end of range, scan total (one cache line per thread)
+    while (items > 0) {
+      // task counts per vertex and their exclusive prefix sum (per-thread blocks, then the block totals)
+      const int beg = (long long)items * tid / nt;
+      const int end = (long long)items * (tid + 1) / nt;
+      int sum = 0;
+      for (int k = beg; k < end; k++) {
+        const int v = in[k];
+        int data;  // const
+        #pragma omp atomic read
+        data = color[v];
+        const int range = data >> (BPI / 2);
+        const int len = (data & Mask) + range;
+        const int tasks = (range == 0) ? 0 : ((len + Grain - 1) / Grain);
+        first[k] = sum;
+        sum += tasks;
+        if (tasks > 1) {
+          split[3 * k] = posscol[v];  // pcol
+          split[3 * k + 1] = 3;  // done | shortcut
+          split[3 * k + 2] = tasks;  // pending chunks
+        }
+      }
+      queue[2] = sum;
+      #pragma omp barrier
+      #pragma omp single
+      {
+        int total = 0;
+        for (int t = 0; t < nt; t++) {
+          const int s = cnt[t * 16 + 2];
+          cnt[t * 16 + 2] = total;
+          total += s;
+        }
+        first[items] = total;
+      }
+      for (int k = beg; k < end; k++) first[k] += queue[2];
+      #pragma omp barrier
+      const int tasks = first[items];
+      queue[0] = (long long)tasks * tid / nt;
+      queue[1] = (long long)tasks * (tid + 1) / nt;
+      #pragma omp barrier
+
+      int victim = tid;
+      int k = -1;
+      while (true) {
+        int x;
+        #pragma omp atomic capture
+        x = cnt[victim * 16]++;
+        if (x >= cnt[victim * 16 + 1]) {
+          victim = (victim + 1) % nt;
+          if (victim == tid) break;  // all queues are drained
+          k = -1;
+          continue;
+        }
+        k = taskSlot(first, items, x, k);
+        const int v = in[k];
+        int data;  // const
+        #pragma omp atomic read
+        data = color[v];
+        const ECLedge vbeg = nidx[v];
+        const int mincol = data & Mask;
+        const int maxcol = mincol + (data >> (BPI / 2));
+        const ECLedge offs = vbeg / BPI;
+        bool done = true;
+        bool shortcut = true;
+        bool again;
+        if (first[k + 1] - first[k] == 1) {
+          int pcol = posscol[v];
+          [[maybe_unused]] const int updates = largeScan(simd, nlist, vbeg, vbeg + maxcol, color, posscol2, offs, mincol, maxcol, pcol, done, shortcut);
+          STAT(threadStats().updates += updates);
+          again = finishLarge(v, pcol, done, shortcut, mincol, maxcol, offs, posscol, posscol2, color);
+        } else {
+          const ECLedge cbeg = vbeg + (ECLedge)(x - first[k]) * Grain;
+          const ECLedge cend = std::min(cbeg + Grain, vbeg + maxcol);
+          int pcol = -1;
+          [[maybe_unused]] const int updates = largeScan(simd, nlist, cbeg, cend, color, posscol2, offs, mincol, maxcol, pcol, done, shortcut);
+          STAT(threadStats().updates += updates);
+          if (pcol != -1) {
+            #pragma omp atomic update
+            split[3 * k] &= pcol;
+          }
+          if (!done || !shortcut) {
+            #pragma omp atomic update
+            split[3 * k + 1] &= (done ? 1 : 0) | (shortcut ? 2 : 0);
+          }
+          int left;
+          #pragma omp atomic capture seq_cst
+          left = --split[3 * k + 2];
+          if (left != 0) continue;
+          int flags;
+          #pragma omp atomic read
+          pcol = split[3 * k];
+          #pragma omp atomic read
+          flags = split[3 * k + 1];
+          again = finishLarge(v, pcol, (flags & 1) != 0, (flags & 2) != 0, mincol, maxcol, offs, posscol, posscol2, color);
+        }
+        if (again) {
+          int pos;
+          #pragma omp atomic capture
+          pos = survivors++;
+          out[pos] = v;
+        }
+      }
+      #pragma omp barrier
+      #pragma omp single
+      {
+        std::swap(in, out);
+        items = survivors;
+        survivors = 0;
+        STAT(if (items > 0) recordRound(0, items));
+      }
+    }
+  }
+}
+
+
+static void runSmall(const int nodes, const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, volatile int* const __restrict__ posscol, int* const __restrict__ color, int* const __restrict__ wl, int* const __restrict__ wl2, int* const __restrict__ cnt, const bool local, const int threads)
+{
+  runWorklist(wl, nodes, wl2, cnt, true, local, threads, 1, [=](const int v) {
+    int pcol;
+    #pragma omp atomic read
+    pcol = posscol[v];
+    if (__builtin_popcount(pcol) <= 1) return false;
+    const ECLedge beg = nidx[v];
+    int active = color[v];
+    int allnei = 0;
+    int keep = active;
+    do {
+      const int old = active;
+      active &= active - 1;
+      const int curr = old ^ active;
+      const ECLedge i = beg + __builtin_clz(curr);
+      const int nei = nlist[i];
+      int neipcol;  // const
+      #pragma omp atomic read
+      neipcol = posscol[nei];
+      allnei |= neipcol;
+      if ((pcol & neipcol) == 0) {
+        pcol &= pcol - 1;
+        keep ^= curr;
+      } else if (__builtin_popcount(neipcol) == 1) {
+        pcol ^= neipcol;
+        keep ^= curr;
+      }
+    } while (active != 0);
+    if (keep != 0) {
+      const int best = (unsigned int)MSB >> __builtin_clz(pcol);
+      if ((best & ~allnei) != 0) {
+        STAT(threadStats().shortcuts[1]++);
+        pcol = best;
+        keep = 0;
+      }
+    }
+    const bool again = (keep != 0);
+    if (keep == 0) keep = __builtin_clz(pcol);
+    color[v] = keep;
+    #pragma omp atomic write
+    posscol[v] = pcol;
+    return again;
+  });
+}
+
+
+#ifdef __linux__
+// reads a /sys list such as "0-3,8-11" (empty if the file does not exist)
+static std::vector<int> readSysList(const char* const fname)
+{
+  std::vector<int> list;
+  FILE* f = fopen(fname, "rt");
+  if (f == NULL) return list;
+  char line[4096];
+  if (fgets(line, sizeof(line), f) != NULL) {
+    char* p = line;
+    while (true) {
+      char* q;
+      const int a = strtol(p, &q, 10);
+      if (q == p) break;
+      int b = a;
+      if (*q == '-') {
+        p = q + 1;
+        b = strtol(p, &q, 10);
+      }
+      for (int c = a; c <= b; c++) list.push_back(c);
+      if (*q != ',') break;
+      p = q + 1;
+    }
+  }
+  fclose(f);
+  return list;
+}
+#endif
+
+int pinThreadsNUMA(const int threads)
+{
+  // cpus of every NUMA node that has any, or a single node with all online cpus if /sys does not say
+  std::vector<std::vector<int>> node;
+#ifdef __linux__
+  const std::vector<int> ids = readSysList("/sys/devices/system/node/online");
+  for (size_t k = 0; k < ids.size(); k++) {
+    char fname[64];
+    snprintf(fname, sizeof(fname), "/sys/devices/system/node/node%d/cpulist", ids[k]);
+    const std::vector<int> cpus = readSysList(fname);
+    if (!cpus.empty()) node.push_back(cpus);
+  }
+#endif
+  if (node.empty()) {
+    node.resize(1);
+    for (int c = 0; c < std::max(1L, sysconf(_SC_NPROCESSORS_ONLN)); c++) node[0].push_back(c);
+  }
+  const int nodes = node.size();
+
+  int failed = 0;
+#ifdef __linux__
+  #pragma omp parallel num_threads(threads) default(none) shared(node, nodes) reduction(+: failed)
+  {
+    // consecutive thread IDs share a node, matching the static vertex partition
+    const int tid = omp_get_thread_num();
+    const int nt = omp_get_num_threads();
+    const int n = (long long)tid * nodes / nt;
+    const int nfirst = ((long long)n * nt + nodes - 1) / nodes;  // first thread on node n
+    const std::vector<int>& cpus = node[n];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[(tid - nfirst) % cpus.size()], &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) failed++;
+  }
+#else
+  failed = threads;
+#endif
+  if (failed > 0) fprintf(stderr, "could not pin %d of %d threads, running unpinned\n", failed, threads);
+  return nodes;
+}
+
+
+ColoringContext::ColoringContext()
+{
+  arena = NULL;
+  capacity = 0;
+  maxnodes = maxthreads = 0;
+  maxedges = 0;
+  color = nlist2 = posscol = posscol2 = wl = wl2 = first = split = cnt = NULL;
+  simd = ECL_SIMD_AUTO;
+  simdused = ECL_SIMD_SCALAR;
+  numa = false;
+  numanodes = 1;
+  pinned = 0;
+  touched = false;
+  for (int p = 0; p < PHASES; p++) times[p] = 0;
+}
+
+ColoringContext::~ColoringContext()
+{
+  free(arena);
+}
+
+// rounds n ints up to whole cache lines
+static size_t arenaBytes(const long long n)
+{
+  const size_t line = 64;
+  return (n * sizeof(int) + line - 1) / line * line;
+}
+
+void ColoringContext::reserve(const int nodes, const ECLedge edges, const int threads)
+{
+  if ((arena != NULL) && (nodes <= maxnodes) && (edges <= maxedges) && (threads <= maxthreads)) return;
+  maxnodes = std::max(maxnodes, nodes);
+  maxedges = std::max(maxedges, edges);
+  maxthreads = std::max(maxthreads, threads);
+  const size_t nsize = arenaBytes(maxnodes);
+  const size_t esize = arenaBytes(maxedges);
+  const size_t psize = arenaBytes(maxedges / BPI + 1);
+  const size_t fsize = arenaBytes(maxnodes + 1);
+  const size_t ssize = arenaBytes(3LL * maxnodes);
+  const size_t csize = arenaBytes(maxthreads * 16);
+  free(arena);
+  capacity = 4 * nsize + esize + psize + fsize + ssize + csize;
+  void* mem;
+  if (posix_memalign(&mem, 64, capacity) != 0) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  arena = (char*)mem;
+  char* p = arena;
+  color = (int*)p;  p += nsize;
+  posscol = (int*)p;  p += nsize;
+  wl = (int*)p;  p += nsize;
+  wl2 = (int*)p;  p += nsize;
+  nlist2 = (int*)p;  p += esize;
+  posscol2 = (int*)p;  p += psize;
+  first = (int*)p;  p += fsize;
+  split = (int*)p;  p += ssize;
+  cnt = (int*)p;
+  touched = false;
+}
+
+void ColoringContext::pinThreads(const int threads)
+{
+  if (pinned == threads) return;
+  numanodes = pinThreadsNUMA(threads);
+  pinned = threads;
+}
+
+// places the pages of the per-vertex and per-edge arrays with the static vertex partition of init
+void ColoringContext::firstTouch(const ECLgraph& g, const int threads)
+{
+  const int nodes = g.nodes;
+  const ECLedge* const nidx = g.nindex;
+  int* const color = this->color;
+  int* const posscol = this->posscol;
+  int* const wl = this->wl;
+  int* const wl2 = this->wl2;
+  int* const first = this->first;
+  int* const split = this->split;
+  int* const nlist2 = this->nlist2;
+  int* const posscol2 = this->posscol2;
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, nidx, color, posscol, wl, wl2, first, split, nlist2, posscol2) schedule(static)
+  for (int v = 0; v < nodes; v++) {
+    color[v] = posscol[v] = wl[v] = wl2[v] = first[v] = 0;
+    split[3 * v] = split[3 * v + 1] = split[3 * v + 2] = 0;
+    std::fill(&nlist2[nidx[v]], &nlist2[nidx[v + 1]], 0);
+    std::fill(&posscol2[nidx[v] / BPI], &posscol2[nidx[v + 1] / BPI + 1], 0);
+  }
+  touched = true;
+}
+
+int ColoringContext::colorGraph(const ECLgraph& g, const int threads)
+{
+  reserve(g.nodes, g.edges, threads);
+  if (numa) {
+    pinThreads(threads);
+    if (!touched) firstTouch(g, threads);
+  }
+  STAT(resetStats(threads));
+  CPUTimer timer;
+  timer.start();
+  // the vector kernels index the low words of 64-bit offsets with 32-bit lanes, which needs nodes < 2^30
+  simdused = ((sizeof(ECLedge) > sizeof(int)) && (g.nodes >= (1 << 30))) ? ECL_SIMD_SCALAR : simdLevel(simd);
+  const int wlsize = init(g.nodes, g.edges, g.nindex, g.nlist, nlist2, posscol, posscol2, color, wl, threads, simdused);
+  times[0] = timer.stop();
+  timer.start();
+  runLarge(g.nindex, nlist2, posscol, posscol2, color, wl, wl2, first, split, cnt, wlsize, threads, simdused);
+  times[1] = timer.stop();
+  timer.start();
+  runSmall(g.nodes, g.nindex, g.nlist, posscol, color, wl, wl2, cnt, numa, threads);
+  times[2] = timer.stop();
+  times[3] = times[0] + times[1] + times[2];
+  return wlsize;
+}
@@ -0,0 +1,96 @@
+#ifndef ECL_GC
+#define ECL_GC
+
+#include <chrono>
+#include "ECLgraph.h"
+
+
+// ECL-GC as a library: link ECL-GC.cpp (compiled with the same -DECL_LARGE_EDGES and -DECL_STATS
+// settings as the caller) and color graphs through a ColoringContext
+
+
+#ifdef ECL_STATS
+#define STAT(...) __VA_ARGS__
+#else
+#define STAT(...)
+#endif
+
+
+struct CPUTimer
+{
+  std::chrono::steady_clock::time_point beg, end;
+  void start() {beg = std::chrono::steady_clock::now();}
+  float stop() {end = std::chrono::steady_clock::now(); return std::chrono::duration<float>(end - beg).count();}
+};
+
+
+// phases timed by ColoringContext::colorGraph
+static const int PHASES = 4;  // init, runLarge, runSmall, total
+static const char* const phasename[PHASES] = {"init", "runLarge", "runSmall", "total"};
+
+
+// kernels for the neighbor scans of init and runLarge (the vector ones exist on x86-64 only)
+static const int ECL_SIMD_AUTO = -1;  // widest one the CPU supports
+static const int ECL_SIMD_SCALAR = 0;
+static const int ECL_SIMD_AVX2 = 1;
+static const int ECL_SIMD_AVX512 = 2;
+static const char* const simdname[3] = {"scalar", "avx2", "avx512"};
+
+// resolves ECL_SIMD_AUTO to the widest supported kernel, exits if an explicitly requested one is not supported
+int simdLevel(const int requested);
+
+
+// pins OpenMP threads so that consecutive thread IDs share a NUMA node (nodes and their cpus come from
+// /sys/devices/system/node); returns the number of nodes
+int pinThreadsNUMA(const int threads);
+
+
+// owns all scratch memory of the coloring kernels in one 64-byte aligned arena that only grows: once it has
+// been sized for the largest graph (and thread count) seen, further colorings do not touch the heap
+struct ColoringContext
+{
+  ColoringContext();
+  ~ColoringContext();
+  ColoringContext(const ColoringContext&) = delete;
+  ColoringContext& operator=(const ColoringContext&) = delete;
+
+  // grows the arena if needed, called by colorGraph (calling it up front keeps allocation out of the timed runs)
+  void reserve(const int nodes, const ECLedge edges, const int threads);
+  // colors g into color[0..g.nodes), which stays valid until the next reserve or colorGraph call;
+  // fills times with the phase times and returns the number of vertices processed by runLarge
+  int colorGraph(const ECLgraph& g, const int threads);
+  // NUMA mode: pins the threads once per thread count (call it before firstTouchECLgraph)
+  void pinThreads(const int threads);
+
+  int simd;  // requested kernels (ECL_SIMD_AUTO by default), all of them produce identical colorings
+  int simdused;  // kernels used by the last colorGraph call
+  bool numa;  // pin threads, first-touch the arena by the static vertex partition and keep runSmall blocks on it
+  int numanodes;  // nodes found by the last pinThreads call
+  int* color;
+  float times[PHASES];
+  size_t capacity;  // arena size in bytes
+
+  // arena layout
+  void firstTouch(const ECLgraph& g, const int threads);
+  int pinned;  // thread count the threads are pinned for
+  bool touched;  // arena pages placed by firstTouch
+  char* arena;
+  int maxnodes, maxthreads;
+  ECLedge maxedges;
+  int* nlist2;
+  int* posscol;
+  int* posscol2;
+  int* wl;
+  int* wl2;
+  int* first;  // first task of every worklist slot in runLarge
+  int* split;  // combined pcol, done/shortcut flags and pending chunks of split hub vertices
+  int* cnt;  // per-block survivor counts of runSmall rounds, per-thread task queues of runLarge
+};
+
+
+#ifdef ECL_STATS
+// per-phase rounds, active vertices and hot-path counters of the last colorGraph call
+void printColoringStats();
+#endif
+
+#endif
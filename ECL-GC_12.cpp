@@ -1,252 +1,267 @@
 #include <algorithm>
-#include <sys/time.h>
-#include "ECLgraph.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "ECL-GC.h"
+#include "ECLrecolor.h"
 
 
-static const int BPI = 32;  // bits per int
-static const int MSB = 1 << (BPI - 1);
-static const int Mask = (1 << (BPI / 2)) - 1;
-
+struct BenchStats
+{
+  double median, min, mean, stddev;
+};
 
-// source of hash function: https://stackoverflow.com/questions/664014/what-integer-hash-function-are-good-that-accepts-an-integer-hash-key
-static unsigned int hash(unsigned int val)
+static BenchStats benchStats(std::vector<double> t)
 {
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  val = ((val >> 16) ^ val) * 0x45d9f3b;
-  return (val >> 16) ^ val;
+  BenchStats s;
+  std::sort(t.begin(), t.end());
+  const int n = t.size();
+  s.median = (n % 2) ? t[n / 2] : (0.5 * (t[n / 2 - 1] + t[n / 2]));
+  s.min = t[0];
+  s.mean = 0;
+  for (int i = 0; i < n; i++) s.mean += t[i];
+  s.mean /= n;
+  double var = 0;
+  for (int i = 0; i < n; i++) var += (t[i] - s.mean) * (t[i] - s.mean);
+  s.stddev = (n > 1) ? sqrt(var / (n - 1)) : 0;
+  return s;
 }
 
 
-static int init(const int nodes, const int edges, const int* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ nlist2, int* const __restrict__ posscol, int* const __restrict__ posscol2, int* const __restrict__ color, int* const __restrict__ wl, const int threads)
+struct BenchResult
 {
-  int wlsize = 0;
-  int maxrange = -1;
-  #pragma omp parallel for num_threads(threads) default(none) reduction(max: maxrange) shared(nodes, wlsize, wl, nidx, nlist, nlist2, color, posscol)
-  for (int v = 0; v < nodes; v++) {
-    int active;
-    const int beg = nidx[v];
-    const int end = nidx[v + 1];
-    const int degv = end - beg;
-    const bool cond = (degv >= BPI);
-    int pos = beg;
-    if (cond) {
-      int tmp;
-      #pragma omp atomic capture
-      tmp = wlsize++;
-      wl[tmp] = v;
-      for (int i = beg; i < end; i++) {
-        const int nei = nlist[i];
-        const int degn = nidx[nei + 1] - nidx[nei];
-        if ((degv < degn) || ((degv == degn) && (hash(v) < hash(nei))) || ((degv == degn) && (hash(v) == hash(nei)) && (v < nei))) {
-          nlist2[pos] = nei;
-          pos++;
-        }
-      }
-    } else {
-      active = 0;
-      for (int i = beg; i < end; i++) {
-        const int nei = nlist[i];
-        const int degn = nidx[nei + 1] - nidx[nei];
-        if ((degv < degn) || ((degv == degn) && (hash(v) < hash(nei))) || ((degv == degn) && (hash(v) == hash(nei)) && (v < nei))) {
-          active |= (unsigned int)MSB >> (i - beg);
-          pos++;
-        }
-      }
+  int threads, wlsize, colors;
+  BenchStats phase[PHASES];
+};
+
+// warmup untimed and reps timed colorings per thread count, the coloring of the last run stays in color
+static std::vector<BenchResult> benchmark(const ECLgraph& g, ColoringContext& ctx, const std::vector<int>& sweep, const int warmup, const int reps)
+{
+  std::vector<BenchResult> res;
+  for (size_t k = 0; k < sweep.size(); k++) {
+    const int threads = sweep[k];
+    BenchResult r;
+    r.threads = threads;
+    ctx.reserve(g.nodes, g.edges, threads);
+    for (int i = 0; i < warmup; i++) ctx.colorGraph(g, threads);
+    std::vector<double> t[PHASES];
+    for (int i = 0; i < reps; i++) {
+      r.wlsize = ctx.colorGraph(g, threads);
+      for (int p = 0; p < PHASES; p++) t[p].push_back(ctx.times[p]);
     }
-    const int range = pos - beg;
-    maxrange = std::max(maxrange, range);  // reduction
-    color[v] = (cond || (range == 0)) ? (range << (BPI / 2)) : active;
-    posscol[v] = (range >= BPI) ? -1 : (MSB >> range);
+    for (int p = 0; p < PHASES; p++) r.phase[p] = benchStats(t[p]);
+    r.colors = 1 + *std::max_element(ctx.color, ctx.color + g.nodes);
+    res.push_back(r);
+    fprintf(stderr, "benchmark: %d threads, median %.6f s\n", threads, r.phase[PHASES - 1].median);
   }
-  if (maxrange >= Mask) {printf("too many active neighbors\n"); exit(-1);}
-  #pragma omp parallel for num_threads(threads) default(none) shared(edges, posscol2)
-  for (int i = 0; i < edges / BPI + 1; i++) posscol2[i] = -1;
-  return wlsize;
+  return res;
 }
 
-
-void runLarge(const int* const __restrict__ nidx, const int* const __restrict__ nlist, int* const __restrict__ posscol, volatile int* const __restrict__ posscol2, volatile int* const __restrict__ color, const int* const __restrict__ wl, const int wlsize, const int threads)
+static void writeBenchmark(FILE* const f, const bool csv, const char* const input, const ECLgraph& g, const int maxdeg, const char* const order, const char* const simd, const int warmup, const int reps, const std::vector<BenchResult>& res)
 {
-  if (wlsize != 0) {
-    bool again;
-    #pragma omp parallel num_threads(threads) default(none) shared(wlsize, wl, nidx, nlist, color, posscol, posscol2) private(again)
-    do {
-      again = false;
-      #pragma omp for nowait
-      for (int w = 0; w < wlsize; w++) {
-        bool shortcut = true;
-        bool done = true;
-        const int v = wl[w];
-        int data;  // const
-        #pragma omp atomic read
-        data = color[v];
-        const int range = data >> (BPI / 2);
-        if (range > 0) {
-          const int beg = nidx[v];
-          int pcol = posscol[v];
-          const int mincol = data & Mask;
-          const int maxcol = mincol + range;
-          const int end = beg + maxcol;
-          const int offs = beg / BPI;
-          for (int i = beg; i < end; i++) {
-            const int nei = nlist[i];
-            int neidata;  // const
-            #pragma omp atomic read
-            neidata = color[nei];
-            const int neirange = neidata >> (BPI / 2);
-            if (neirange == 0) {
-              const int neicol = neidata;
-              if (neicol < BPI) {
-                pcol &= ~((unsigned int)MSB >> neicol);
-              } else {
-                if ((mincol <= neicol) && (neicol < maxcol)) {
-                  int pc;  // const
-                  #pragma omp atomic read
-                  pc = posscol2[offs + neicol / BPI];
-                  if ((pc << (neicol % BPI)) < 0) {
-                    #pragma omp atomic update
-                    posscol2[offs + neicol / BPI] &= ~((unsigned int)MSB >> (neicol % BPI));
-                  }
-                }
-              }
-            } else {
-              done = false;
-              const int neimincol = neidata & Mask;
-              const int neimaxcol = neimincol + neirange;
-              if ((neimincol <= mincol) && (neimaxcol >= mincol)) shortcut = false;
-            }
-          }
-          int val = pcol;
-          int mc = 0;
-          if (pcol == 0) {
-            const int offs = beg / BPI;
-            mc = std::max(1, mincol / BPI) - 1;
-            do {
-              mc++;
-              #pragma omp atomic read
-              val = posscol2[offs + mc];
-            } while (val == 0);
-          }
-          int newmincol = mc * BPI + __builtin_clz(val);
-          if (mincol != newmincol) shortcut = false;
-          if (shortcut || done) {
-            pcol = (newmincol < BPI) ? ((unsigned int)MSB >> newmincol) : 0;
-          } else {
-            const int maxcol = mincol + range;
-            const int range = maxcol - newmincol;
-            newmincol = (range << (BPI / 2)) | newmincol;
-            again = true;
-          }
-          posscol[v] = pcol;
-          #pragma omp atomic write
-          color[v] = newmincol;
-        }
-      }
-    } while (again);
+  if (csv) {
+    fprintf(f, "input,nodes,edges,max_degree,reorder,simd,threads,warmup,reps,wlsize,colors");
+    for (int p = 0; p < PHASES; p++) fprintf(f, ",%s_median_s,%s_min_s,%s_mean_s,%s_stddev_s", phasename[p], phasename[p], phasename[p], phasename[p]);
+    fprintf(f, ",mnodes_per_s,medges_per_s\n");
+    for (size_t k = 0; k < res.size(); k++) {
+      const BenchResult& r = res[k];
+      fprintf(f, "%s,%d,%lld,%d,%s,%s,%d,%d,%d,%d,%d", input, g.nodes, (long long)g.edges, maxdeg, order, simd, r.threads, warmup, reps, r.wlsize, r.colors);
+      for (int p = 0; p < PHASES; p++) fprintf(f, ",%.9f,%.9f,%.9f,%.9f", r.phase[p].median, r.phase[p].min, r.phase[p].mean, r.phase[p].stddev);
+      fprintf(f, ",%.6f,%.6f\n", g.nodes * 0.000001 / r.phase[PHASES - 1].median, g.edges * 0.000001 / r.phase[PHASES - 1].median);
+    }
+  } else {
+    fprintf(f, "{\n  \"input\": \"%s\",\n  \"nodes\": %d,\n  \"edges\": %lld,\n  \"max_degree\": %d,\n  \"edge_offset_bits\": %d,\n", input, g.nodes, (long long)g.edges, maxdeg, (int)sizeof(ECLedge) * 8);
+    fprintf(f, "  \"reorder\": \"%s\",\n  \"simd\": \"%s\",\n  \"warmup\": %d,\n  \"reps\": %d,\n  \"results\": [\n", order, simd, warmup, reps);
+    for (size_t k = 0; k < res.size(); k++) {
+      const BenchResult& r = res[k];
+      fprintf(f, "    {\"threads\": %d, \"wlsize\": %d, \"colors\": %d", r.threads, r.wlsize, r.colors);
+      for (int p = 0; p < PHASES; p++) fprintf(f, ", \"%s\": {\"median\": %.9f, \"min\": %.9f, \"mean\": %.9f, \"stddev\": %.9f}", phasename[p], r.phase[p].median, r.phase[p].min, r.phase[p].mean, r.phase[p].stddev);
+      fprintf(f, ", \"mnodes_per_s\": %.6f, \"medges_per_s\": %.6f}%s\n", g.nodes * 0.000001 / r.phase[PHASES - 1].median, g.edges * 0.000001 / r.phase[PHASES - 1].median, (k + 1 < res.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
   }
 }
 
 
-void runSmall(const int nodes, const int* const __restrict__ nidx, const int* const __restrict__ nlist, volatile int* const __restrict__ posscol, int* const __restrict__ color, const int threads)
+static void verifyColoring(const ECLgraph& g, const int* const color)
 {
-  bool again;
-  #pragma omp parallel num_threads(threads) default(none) shared(nodes, nidx, nlist, color, posscol) private(again)
-  do {
-    again = false;
-    #pragma omp for nowait
-    for (int v = 0; v < nodes; v++) {
-      int pcol;
-      #pragma omp atomic read
-      pcol = posscol[v];
-      if (__builtin_popcount(pcol) > 1) {
-        const int beg = nidx[v];
-        int active = color[v];
-        int allnei = 0;
-        int keep = active;
-        do {
-          const int old = active;
-          active &= active - 1;
-          const int curr = old ^ active;
-          const int i = beg + __builtin_clz(curr);
-          const int nei = nlist[i];
-          int neipcol;  // const
-          #pragma omp atomic read
-          neipcol = posscol[nei];
-          allnei |= neipcol;
-          if ((pcol & neipcol) == 0) {
-            pcol &= pcol - 1;
-            keep ^= curr;
-          } else if (__builtin_popcount(neipcol) == 1) {
-            pcol ^= neipcol;
-            keep ^= curr;
-          }
-        } while (active != 0);
-        if (keep != 0) {
-          const int best = (unsigned int)MSB >> __builtin_clz(pcol);
-          if ((best & ~allnei) != 0) {
-            pcol = best;
-            keep = 0;
-          }
-        }
-        again |= keep;
-        if (keep == 0) keep = __builtin_clz(pcol);
-        color[v] = keep;
-        #pragma omp atomic write
-        posscol[v] = pcol;
-      }
+  for (int v = 0; v < g.nodes; v++) {
+    if (color[v] < 0) {printf("ERROR: found unprocessed node in graph (node %d with deg %d)\n\n", v, (int)(g.nindex[v + 1] - g.nindex[v]));  exit(-1);}
+    for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
+      if (color[g.nlist[i]] == color[v]) {printf("ERROR: found adjacent nodes with same color %d (%d %d)\n\n", color[v], v, g.nlist[i]);  exit(-1);}
     }
-  } while (again);
+  }
+  printf("result verification passed\n");
 }
 
 
-struct CPUTimer
-{
-  timeval beg, end;
-  void start() {gettimeofday(&beg, NULL);}
-  float stop() {gettimeofday(&end, NULL); return end.tv_sec - beg.tv_sec + (end.tv_usec - beg.tv_usec) * 0.000001f;}
-};
-
-
 int main(int argc, char* argv[])
 {
   printf("ECL-GC OpenMP v1.2 (%s)\n", __FILE__);
   printf("Copyright 2020 Texas State University\n\n");
 
-  if (argc != 3) {printf("USAGE: %s input_file_name thread_count\n\n", argv[0]);  exit(-1);}
-  if (BPI != sizeof(int) * 8) {printf("ERROR: bits per int size must be %ld\n\n", sizeof(int) * 8);  exit(-1);}
+  if (argc < 3) {
+    printf("USAGE: %s input_file_name thread_count [options]\n", argv[0]);
+    printf("  --mmap, --populate, --hugepages   map the input file (see README.md)\n");
+    printf("  --clean                           symmetrize, drop duplicate edges and self-loops\n");
+    printf("  --numa                            pin threads and first-touch the graph and arrays per NUMA node\n");
+    printf("  --reorder=degree|rcm|community    relabel vertices for locality\n");
+    printf("  --bench=N                         benchmark mode with N timed repetitions\n");
+    printf("  --warmup=N                        untimed repetitions per thread count (default 1)\n");
+    printf("  --threads=T1,T2,...               thread counts to sweep (default thread_count)\n");
+    printf("  --format=json|csv                 benchmark report format (default json)\n");
+    printf("  --out=file                        write the benchmark report to file instead of stdout\n");
+    printf("  --simd=auto|scalar|avx2|avx512    neighbor scan kernels of init and runLarge (default auto)\n");
+    printf("  --updates=file                    apply a batch of edge/vertex updates and recolor incrementally\n\n");
+    exit(-1);
+  }
   const int threads = atoi(argv[2]);
   if (threads < 1) {fprintf(stderr, "ERROR: thread_count must be at least 1\n"); exit(-1);}
 
-  ECLgraph g = readECLgraph(argv[1]);
+  bool mapped = false;
+  bool clean = false;
+  int mapflags = 0;
+  int order = 0;
+  int reps = 0;
+  int warmup = 1;
+  bool csv = false;
+  const char* out = NULL;
+  const char* updates = NULL;
+  int simd = ECL_SIMD_AUTO;
+  bool numa = false;
+  std::vector<int> sweep;
+  for (int i = 3; i < argc; i++) {
+    if (strcmp(argv[i], "--mmap") == 0) {
+      mapped = true;
+    } else if (strcmp(argv[i], "--populate") == 0) {
+      mapped = true;
+      mapflags |= ECL_MAP_POPULATE;
+    } else if (strcmp(argv[i], "--hugepages") == 0) {
+      mapped = true;
+      mapflags |= ECL_MAP_HUGEPAGES;
+    } else if (strcmp(argv[i], "--numa") == 0) {
+      numa = true;
+    } else if (strcmp(argv[i], "--clean") == 0) {
+      clean = true;
+    } else if (strcmp(argv[i], "--reorder=degree") == 0) {
+      order = ECL_ORDER_DEGREE;
+    } else if (strcmp(argv[i], "--reorder=rcm") == 0) {
+      order = ECL_ORDER_RCM;
+    } else if (strcmp(argv[i], "--reorder=community") == 0) {
+      order = ECL_ORDER_COMMUNITY;
+    } else if (strncmp(argv[i], "--bench=", 8) == 0) {
+      reps = atoi(argv[i] + 8);
+      if (reps < 1) {fprintf(stderr, "ERROR: --bench needs at least 1 repetition\n");  exit(-1);}
+    } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+      warmup = atoi(argv[i] + 9);
+      if (warmup < 0) {fprintf(stderr, "ERROR: --warmup must not be negative\n");  exit(-1);}
+    } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+      const char* p = argv[i] + 10;
+      while (*p != 0) {
+        char* q;
+        const int t = strtol(p, &q, 10);
+        if ((q == p) || (t < 1) || ((*q != ',') && (*q != 0))) {fprintf(stderr, "ERROR: malformed thread list %s\n", argv[i] + 10);  exit(-1);}
+        sweep.push_back(t);
+        p = (*q == ',') ? (q + 1) : q;
+      }
+    } else if (strcmp(argv[i], "--format=json") == 0) {
+      csv = false;
+    } else if (strcmp(argv[i], "--format=csv") == 0) {
+      csv = true;
+    } else if (strncmp(argv[i], "--out=", 6) == 0) {
+      out = argv[i] + 6;
+    } else if (strcmp(argv[i], "--simd=auto") == 0) {
+      simd = ECL_SIMD_AUTO;
+    } else if (strcmp(argv[i], "--simd=scalar") == 0) {
+      simd = ECL_SIMD_SCALAR;
+    } else if (strcmp(argv[i], "--simd=avx2") == 0) {
+      simd = ECL_SIMD_AVX2;
+    } else if (strcmp(argv[i], "--simd=avx512") == 0) {
+      simd = ECL_SIMD_AVX512;
+    } else if (strncmp(argv[i], "--updates=", 10) == 0) {
+      updates = argv[i] + 10;
+    } else {
+      fprintf(stderr, "ERROR: unknown option %s\n", argv[i]);  exit(-1);
+    }
+  }
+  if (sweep.empty()) sweep.push_back(threads);
+
+  CPUTimer timer;
+  timer.start();
+  ECLgraph g = mapped ? mapECLgraph(argv[1], mapflags) : readECLgraph(argv[1]);
+  const float loadtime = timer.stop();
   printf("input: %s\n", argv[1]);
+  printf("load time: %.6f s (%s)\n", loadtime, mapped ? "mmap" : "read");
+  if (clean) {
+    const ECLedge edges = g.edges;
+    timer.start();
+    const long long loops = cleanECLgraph(g, threads);
+    const float cleantime = timer.stop();
+    printf("clean time: %.6f s (%lld -> %lld edges, %lld self-loops dropped)\n", cleantime, (long long)edges, (long long)g.edges, loops);
+  }
   printf("nodes: %d\n", g.nodes);
-  printf("edges: %d\n", g.edges);
+  printf("edges: %lld (%d-bit offsets)\n", (long long)g.edges, (int)sizeof(ECLedge) * 8);
   printf("avg degree: %.2f\n", 1.0 * g.edges / g.nodes);
 
-  int* const color = new int [g.nodes];
-  int* const nlist2 = new int [g.edges];
-  int* const posscol = new int [g.nodes];
-  int* const posscol2 = new int [g.edges / BPI + 1];
-  int* const wl = new int [g.nodes];
+  // the kernels run on a relabeled copy when reordering, colors are mapped back to the original IDs afterwards
+  ECLgraph rg = g;
+  int* perm = NULL;
+  const char* const ordername = (order == ECL_ORDER_DEGREE) ? "degree" : (order == ECL_ORDER_RCM) ? "rcm" : (order == ECL_ORDER_COMMUNITY) ? "community" : "none";
+  if (order != 0) {
+    timer.start();
+    perm = new int [g.nodes];
+    orderECLgraph(g, order, perm, threads);
+    rg = permuteECLgraph(g, perm, threads);
+    const float reordertime = timer.stop();
+    printf("reorder time: %.6f s (%s)\n", reordertime, ordername);
+  }
 
-  CPUTimer timer;
-  timer.start();
-  const int wlsize = init(g.nodes, g.edges, g.nindex, g.nlist, nlist2, posscol, posscol2, color, wl, threads);
-  runLarge(g.nindex, nlist2, posscol, posscol2, color, wl, wlsize, threads);
-  runSmall(g.nodes, g.nindex, g.nlist, posscol, color, threads);
-  const float runtime = timer.stop();
+  ColoringContext ctx;
+  ctx.simd = simd;
+  ctx.numa = numa;
+  if (numa) {
+    timer.start();
+    ctx.pinThreads(threads);
+    const ECLgraph tg = firstTouchECLgraph(rg, threads);
+    if (rg.nindex != g.nindex) freeECLgraph(rg);
+    rg = tg;
+    const float numatime = timer.stop();
+    printf("numa: %d node(s), %d threads pinned, CSR first-touched in %.6f s\n", ctx.numanodes, threads, numatime);
+  }
+  ctx.reserve(g.nodes, g.edges, threads);
+  printf("workspace: %.1f MB\n", ctx.capacity * 0.000001);
+  printf("simd: %s\n", simdname[simdLevel(simd)]);
 
-  printf("runtime:    %.6f s\n", runtime);
-  printf("throughput: %.6f Mnodes/s\n", g.nodes * 0.000001 / runtime);
-  printf("throughput: %.6f Medges/s\n", g.edges * 0.000001 / runtime);
+  if (reps == 0) {
+    ctx.colorGraph(rg, threads);
+    const float runtime = ctx.times[PHASES - 1];
+    printf("runtime:    %.6f s\n", runtime);
+    printf("throughput: %.6f Mnodes/s\n", g.nodes * 0.000001 / runtime);
+    printf("throughput: %.6f Medges/s\n", g.edges * 0.000001 / runtime);
+    STAT(printColoringStats());
+  } else {
+    int maxdeg = 0;
+    #pragma omp parallel for num_threads(threads) default(none) shared(g) reduction(max: maxdeg)
+    for (int v = 0; v < g.nodes; v++) maxdeg = std::max(maxdeg, (int)(g.nindex[v + 1] - g.nindex[v]));
+    const std::vector<BenchResult> res = benchmark(rg, ctx, sweep, warmup, reps);
+    FILE* const f = (out == NULL) ? stdout : fopen(out, "w");
+    if (f == NULL) {fprintf(stderr, "ERROR: could not open file %s\n\n", out);  exit(-1);}
+    writeBenchmark(f, csv, argv[1], g, maxdeg, ordername, simdname[ctx.simdused], warmup, reps, res);
+    if (f != stdout) fclose(f);
+    STAT(printColoringStats());  // last run
+  }
 
-  for (int v = 0; v < g.nodes; v++) {
-    if (color[v] < 0) {printf("ERROR: found unprocessed node in graph (node %d with deg %d)\n\n", v, g.nindex[v + 1] - g.nindex[v]);  exit(-1);}
-    for (int i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
-      if (color[g.nlist[i]] == color[v]) {printf("ERROR: found adjacent nodes with same color %d (%d %d)\n\n", color[v], v, g.nlist[i]);  exit(-1);}
-    }
+  int* const color = ctx.color;
+  if (perm != NULL) {
+    int* const tmp = ctx.wl;  // scratch, the coloring is done
+    #pragma omp parallel for num_threads(threads) default(none) shared(g, perm, color, tmp)
+    for (int v = 0; v < g.nodes; v++) tmp[v] = color[perm[v]];
+    std::copy(tmp, tmp + g.nodes, color);
+    delete [] perm;
   }
-  printf("result verification passed\n");
+  if (rg.nindex != g.nindex) freeECLgraph(rg);
+
+  verifyColoring(g, color);
 
   const int vals = 16;
   int c[vals];
@@ -265,12 +280,25 @@ int main(int argc, char* argv[])
     printf("col %2d: %10d (%5.1f%%)\n", i, c[i], 100.0 * sum / g.nodes);
   }
 
-  delete [] color;
-  delete [] nlist2;
-  delete [] posscol;
-  delete [] posscol2;
-  delete [] wl;
+  if (updates != NULL) {
+    const std::vector<ECLupdate> upd = readECLupdates(updates);
+    const int oldnodes = g.nodes;
+    timer.start();
+    applyECLupdates(g, upd.data(), upd.size(), threads);
+    const float applytime = timer.stop();
+    int* const ucolor = new int [g.nodes];
+    std::copy(color, color + oldnodes, ucolor);
+    timer.start();
+    const int recolored = recolorECLgraph(g, ucolor, oldnodes, upd.data(), upd.size(), threads);
+    const float recolortime = timer.stop();
+    printf("updates: %d (apply %.6f s, recolor %.6f s, %d vertices recolored)\n", (int)upd.size(), applytime, recolortime, recolored);
+    printf("nodes: %d\n", g.nodes);
+    printf("edges: %lld\n", (long long)g.edges);
+    verifyColoring(g, ucolor);
+    printf("colors used: %d\n", 1 + *std::max_element(ucolor, ucolor + g.nodes));
+    delete [] ucolor;
+  }
+
   freeECLgraph(g);
   return 0;
 }
-
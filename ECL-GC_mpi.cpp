@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <vector>
+#include <mpi.h>
+#include "ECLgraph.h"
+
+
+// distributed-memory ECL-GC: every rank owns a contiguous vertex range of the graph (balanced by edges), keeps
+// ghost copies of the color and posscol values of the neighbors other ranks own, and runs init, runLarge and
+// runSmall in bulk-synchronous rounds; after each round the boundary values are exchanged in one batched
+// MPI_Alltoallv, which only makes the ghost values up to one round stale (the algorithm tolerates stale reads)
+
+
+static const int BPI = 32;  // bits per int
+static const int MSB = 1 << (BPI - 1);
+static const int Mask = (1 << (BPI / 2)) - 1;
+static_assert(BPI == sizeof(int) * 8, "bits per int must match the size of int");
+
+
+// source of hash function: https://stackoverflow.com/questions/664014/what-integer-hash-function-are-good-that-accepts-an-integer-hash-key
+static unsigned int hash(unsigned int val)
+{
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+
+// the part of the graph a rank works on: local vertices 0..locals-1 are the owned global IDs lo..hi-1,
+// locals..locals+ghosts-1 are copies of neighbors owned by other ranks (sorted by global ID, so grouped by owner)
+struct Partition {
+  int ranks, rank;
+  int lo, hi, locals, ghosts;
+  std::vector<int> bound;  // vertex range of every rank
+  std::vector<ECLedge> nidx;  // local CSR
+  std::vector<int> nlist;  // local neighbor indices
+  std::vector<int> gid;  // global IDs of the ghosts
+  std::vector<int> sendcnt, senddsp, recvcnt, recvdsp;
+  std::vector<int> sendidx;  // local vertices other ranks hold ghosts of, grouped by destination
+  std::vector<int> sendbuf;
+};
+
+static int globalID(const Partition& p, const int u) {return (u < p.locals) ? (p.lo + u) : p.gid[u - p.locals];}
+
+// copies the values of the boundary vertices into the ghost slots of all ranks that need them (one batched message per round)
+static void exchange(Partition& p, int* const val)
+{
+  for (size_t k = 0; k < p.sendidx.size(); k++) p.sendbuf[k] = val[p.sendidx[k]];
+  MPI_Alltoallv(p.sendbuf.data(), p.sendcnt.data(), p.senddsp.data(), MPI_INT, &val[p.locals], p.recvcnt.data(), p.recvdsp.data(), MPI_INT, MPI_COMM_WORLD);
+}
+
+// partitions the mapped graph (only the owned parts of nindex and nlist are touched) and sets up the ghost exchange
+static Partition partitionGraph(const ECLgraph& g)
+{
+  Partition p;
+  MPI_Comm_size(MPI_COMM_WORLD, &p.ranks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &p.rank);
+  p.bound.resize(p.ranks + 1);
+  for (int r = 0; r <= p.ranks; r++) {
+    const ECLedge target = (long long)g.edges * r / p.ranks;
+    p.bound[r] = (r == p.ranks) ? g.nodes : (std::lower_bound(g.nindex, g.nindex + g.nodes, target) - g.nindex);
+  }
+  p.lo = p.bound[p.rank];
+  p.hi = p.bound[p.rank + 1];
+  p.locals = p.hi - p.lo;
+
+  const ECLedge beg = g.nindex[p.lo];
+  const ECLedge edges = g.nindex[p.hi] - beg;
+  for (ECLedge i = 0; i < edges; i++) {
+    const int nei = g.nlist[beg + i];
+    if ((nei < p.lo) || (nei >= p.hi)) p.gid.push_back(nei);
+  }
+  std::sort(p.gid.begin(), p.gid.end());
+  p.gid.erase(std::unique(p.gid.begin(), p.gid.end()), p.gid.end());
+  p.ghosts = p.gid.size();
+
+  p.nidx.resize(p.locals + 1);
+  p.nlist.resize(edges);
+  for (int v = 0; v <= p.locals; v++) p.nidx[v] = g.nindex[p.lo + v] - beg;
+  for (ECLedge i = 0; i < edges; i++) {
+    const int nei = g.nlist[beg + i];
+    p.nlist[i] = ((nei >= p.lo) && (nei < p.hi)) ? (nei - p.lo) : (p.locals + (std::lower_bound(p.gid.begin(), p.gid.end(), nei) - p.gid.begin()));
+  }
+
+  // ghost requests: every rank tells the owners which of their vertices it needs
+  p.recvcnt.assign(p.ranks, 0);
+  p.recvdsp.assign(p.ranks, 0);
+  for (int k = 0; k < p.ghosts; k++) p.recvcnt[std::upper_bound(p.bound.begin(), p.bound.end(), p.gid[k]) - p.bound.begin() - 1]++;
+  for (int r = 1; r < p.ranks; r++) p.recvdsp[r] = p.recvdsp[r - 1] + p.recvcnt[r - 1];
+  p.sendcnt.resize(p.ranks);
+  p.senddsp.assign(p.ranks, 0);
+  MPI_Alltoall(p.recvcnt.data(), 1, MPI_INT, p.sendcnt.data(), 1, MPI_INT, MPI_COMM_WORLD);
+  for (int r = 1; r < p.ranks; r++) p.senddsp[r] = p.senddsp[r - 1] + p.sendcnt[r - 1];
+  p.sendidx.resize(p.senddsp[p.ranks - 1] + p.sendcnt[p.ranks - 1]);
+  MPI_Alltoallv(p.gid.data(), p.recvcnt.data(), p.recvdsp.data(), MPI_INT, p.sendidx.data(), p.sendcnt.data(), p.senddsp.data(), MPI_INT, MPI_COMM_WORLD);
+  for (size_t k = 0; k < p.sendidx.size(); k++) p.sendidx[k] -= p.lo;
+  p.sendbuf.resize(p.sendidx.size());
+  return p;
+}
+
+
+static int init(Partition& p, const int* const deg, int* const nlist2, int* const posscol, int* const posscol2, int* const color, int* const wl, const int threads)
+{
+  const int locals = p.locals;
+  const ECLedge* const nidx = p.nidx.data();
+  const int* const nlist = p.nlist.data();
+  const Partition& cp = p;
+  int wlsize = 0;
+  int maxrange = -1;
+  #pragma omp parallel for num_threads(threads) default(none) reduction(max: maxrange) shared(cp, locals, wlsize, wl, nidx, nlist, nlist2, deg, color, posscol) schedule(static)
+  for (int v = 0; v < locals; v++) {
+    int active = 0;
+    const ECLedge beg = nidx[v];
+    const ECLedge end = nidx[v + 1];
+    const int degv = deg[v];
+    const int idv = cp.lo + v;
+    const bool cond = (degv >= BPI);
+    ECLedge pos = beg;
+    if (cond) {
+      int tmp;
+      #pragma omp atomic capture
+      tmp = wlsize++;
+      wl[tmp] = v;
+    }
+    for (ECLedge i = beg; i < end; i++) {
+      const int nei = nlist[i];
+      const int degn = deg[nei];
+      const int idn = globalID(cp, nei);
+      if ((degv < degn) || ((degv == degn) && (hash(idv) < hash(idn))) || ((degv == degn) && (hash(idv) == hash(idn)) && (idv < idn))) {
+        if (cond) {
+          nlist2[pos] = nei;
+        } else {
+          active |= (unsigned int)MSB >> (i - beg);
+        }
+        pos++;
+      }
+    }
+    const int range = pos - beg;
+    maxrange = std::max(maxrange, range);  // reduction
+    color[v] = (cond || (range == 0)) ? (range << (BPI / 2)) : active;
+    posscol[v] = (range >= BPI) ? -1 : (MSB >> range);
+  }
+  if (maxrange >= Mask) {printf("too many active neighbors\n"); exit(-1);}
+  const ECLedge words = nidx[locals] / BPI + 1;
+  #pragma omp parallel for num_threads(threads) default(none) shared(words, posscol2)
+  for (ECLedge i = 0; i < words; i++) posscol2[i] = -1;
+  return wlsize;
+}
+
+
+// one pass over the local large vertices in wl[0..wlsize), returns the survivors in wl2
+static int largeRound(const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist2, int* const __restrict__ posscol, volatile int* const __restrict__ posscol2, volatile int* const __restrict__ color, const int* const __restrict__ wl, const int wlsize, int* const __restrict__ wl2, const int threads)
+{
+  int survivors = 0;
+  #pragma omp parallel for num_threads(threads) default(none) shared(nidx, nlist2, posscol, posscol2, color, wl, wlsize, wl2, survivors) schedule(dynamic, 64)
+  for (int w = 0; w < wlsize; w++) {
+    const int v = wl[w];
+    bool shortcut = true;
+    bool done = true;
+    int data;  // const
+    #pragma omp atomic read
+    data = color[v];
+    const int range = data >> (BPI / 2);
+    if (range == 0) continue;
+    const ECLedge beg = nidx[v];
+    int pcol = posscol[v];
+    const int mincol = data & Mask;
+    const int maxcol = mincol + range;
+    const ECLedge end = beg + maxcol;
+    const ECLedge offs = beg / BPI;
+    for (ECLedge i = beg; i < end; i++) {
+      const int nei = nlist2[i];
+      int neidata;  // const
+      #pragma omp atomic read
+      neidata = color[nei];
+      const int neirange = neidata >> (BPI / 2);
+      if (neirange == 0) {
+        const int neicol = neidata;
+        if (neicol < BPI) {
+          pcol &= ~((unsigned int)MSB >> neicol);
+        } else {
+          if ((mincol <= neicol) && (neicol < maxcol)) {
+            int pc;  // const
+            #pragma omp atomic read
+            pc = posscol2[offs + neicol / BPI];
+            if ((pc << (neicol % BPI)) < 0) {
+              #pragma omp atomic update
+              posscol2[offs + neicol / BPI] &= ~((unsigned int)MSB >> (neicol % BPI));
+            }
+          }
+        }
+      } else {
+        done = false;
+        const int neimincol = neidata & Mask;
+        const int neimaxcol = neimincol + neirange;
+        if ((neimincol <= mincol) && (neimaxcol >= mincol)) shortcut = false;
+      }
+    }
+    int val = pcol;
+    int mc = 0;
+    if (pcol == 0) {
+      mc = std::max(1, mincol / BPI) - 1;
+      do {
+        mc++;
+        #pragma omp atomic read
+        val = posscol2[offs + mc];
+      } while (val == 0);
+    }
+    int newmincol = mc * BPI + __builtin_clz(val);
+    if (mincol != newmincol) shortcut = false;
+    if (shortcut || done) {
+      pcol = (newmincol < BPI) ? ((unsigned int)MSB >> newmincol) : 0;
+    } else {
+      const int range = maxcol - newmincol;
+      newmincol = (range << (BPI / 2)) | newmincol;
+      int tmp;
+      #pragma omp atomic capture
+      tmp = survivors++;
+      wl2[tmp] = v;
+    }
+    posscol[v] = pcol;
+    #pragma omp atomic write
+    color[v] = newmincol;
+  }
+  return survivors;
+}
+
+
+// one pass over the local small vertices in wl[0..wlsize) (all local vertices in the first round, the large
+// ones drop out right away), returns the survivors in wl2
+static int smallRound(const ECLedge* const __restrict__ nidx, const int* const __restrict__ nlist, volatile int* const __restrict__ posscol, int* const __restrict__ color, const int* const __restrict__ wl, const int wlsize, int* const __restrict__ wl2, const int threads)
+{
+  int survivors = 0;
+  #pragma omp parallel for num_threads(threads) default(none) shared(nidx, nlist, posscol, color, wl, wlsize, wl2, survivors) schedule(dynamic, 256)
+  for (int w = 0; w < wlsize; w++) {
+    const int v = wl[w];
+    int pcol;
+    #pragma omp atomic read
+    pcol = posscol[v];
+    if (__builtin_popcount(pcol) <= 1) continue;
+    const ECLedge beg = nidx[v];
+    int active = color[v];
+    int allnei = 0;
+    int keep = active;
+    do {
+      const int old = active;
+      active &= active - 1;
+      const int curr = old ^ active;
+      const ECLedge i = beg + __builtin_clz(curr);
+      const int nei = nlist[i];
+      int neipcol;  // const
+      #pragma omp atomic read
+      neipcol = posscol[nei];
+      allnei |= neipcol;
+      if ((pcol & neipcol) == 0) {
+        pcol &= pcol - 1;
+        keep ^= curr;
+      } else if (__builtin_popcount(neipcol) == 1) {
+        pcol ^= neipcol;
+        keep ^= curr;
+      }
+    } while (active != 0);
+    if (keep != 0) {
+      const int best = (unsigned int)MSB >> __builtin_clz(pcol);
+      if ((best & ~allnei) != 0) {
+        pcol = best;
+        keep = 0;
+      }
+    }
+    if (keep != 0) {
+      int tmp;
+      #pragma omp atomic capture
+      tmp = survivors++;
+      wl2[tmp] = v;
+    } else {
+      keep = __builtin_clz(pcol);
+    }
+    color[v] = keep;
+    #pragma omp atomic write
+    posscol[v] = pcol;
+  }
+  return survivors;
+}
+
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  int rank, ranks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+  if (rank == 0) {
+    printf("ECL-GC MPI v1.2 (%s)\n", __FILE__);
+    printf("Copyright 2020 Texas State University\n\n");
+  }
+
+  if (argc != 3) {if (rank == 0) printf("USAGE: mpirun -np N %s input_file_name thread_count\n\n", argv[0]);  MPI_Finalize();  exit(-1);}
+  const int threads = atoi(argv[2]);
+  if (threads < 1) {fprintf(stderr, "ERROR: thread_count must be at least 1\n");  MPI_Abort(MPI_COMM_WORLD, -1);}
+
+  double beg = MPI_Wtime();
+  ECLgraph g = mapECLgraph(argv[1]);  // every rank only faults in the pages of its own part
+  Partition p = partitionGraph(g);
+  const int nodes = g.nodes;
+  const long long edges = g.edges;
+  freeECLgraph(g);
+  const int all = p.locals + p.ghosts;
+  long long ghosts = p.ghosts, maxghosts = p.ghosts, sends = p.sendidx.size();
+  MPI_Allreduce(MPI_IN_PLACE, &ghosts, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &maxghosts, 1, MPI_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &sends, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+  const double setup = MPI_Wtime() - beg;
+  if (rank == 0) {
+    printf("input: %s\n", argv[1]);
+    printf("nodes: %d\n", nodes);
+    printf("edges: %lld\n", edges);
+    printf("ranks: %d (%d threads each)\n", ranks, threads);
+    printf("ghosts: %lld total, %lld on the busiest rank, %lld values sent per exchange\n", ghosts, maxghosts, sends);
+    printf("setup time: %.6f s\n", setup);
+  }
+
+  std::vector<int> deg(all), color(all), posscol(all), wl(std::max(p.locals, 1)), wl2(std::max(p.locals, 1));
+  std::vector<int> nlist2(std::max(p.nidx[p.locals], (ECLedge)1)), posscol2(p.nidx[p.locals] / BPI + 1);
+  for (int v = 0; v < p.locals; v++) deg[v] = p.nidx[v + 1] - p.nidx[v];
+  exchange(p, deg.data());
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  beg = MPI_Wtime();
+  int wlsize = init(p, deg.data(), nlist2.data(), posscol.data(), posscol2.data(), color.data(), wl.data(), threads);
+  exchange(p, color.data());
+  exchange(p, posscol.data());
+  const double inittime = MPI_Wtime() - beg;
+
+  beg = MPI_Wtime();
+  int large = 0;
+  long long left = wlsize;
+  MPI_Allreduce(MPI_IN_PLACE, &left, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+  while (left > 0) {
+    wlsize = largeRound(p.nidx.data(), nlist2.data(), posscol.data(), posscol2.data(), color.data(), wl.data(), wlsize, wl2.data(), threads);
+    std::swap(wl, wl2);
+    exchange(p, color.data());
+    left = wlsize;
+    MPI_Allreduce(MPI_IN_PLACE, &left, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    large++;
+  }
+  exchange(p, posscol.data());
+  const double largetime = MPI_Wtime() - beg;
+
+  beg = MPI_Wtime();
+  int small = 0;
+  for (int v = 0; v < p.locals; v++) wl[v] = v;
+  wlsize = p.locals;
+  left = wlsize;
+  MPI_Allreduce(MPI_IN_PLACE, &left, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+  while (left > 0) {
+    wlsize = smallRound(p.nidx.data(), p.nlist.data(), posscol.data(), color.data(), wl.data(), wlsize, wl2.data(), threads);
+    std::swap(wl, wl2);
+    exchange(p, posscol.data());
+    left = wlsize;
+    MPI_Allreduce(MPI_IN_PLACE, &left, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    small++;
+  }
+  exchange(p, color.data());
+  const double smalltime = MPI_Wtime() - beg;
+  const double runtime = inittime + largetime + smalltime;
+
+  if (rank == 0) {
+    printf("init time:     %.6f s\n", inittime);
+    printf("runLarge time: %.6f s (%d rounds)\n", largetime, large);
+    printf("runSmall time: %.6f s (%d rounds)\n", smalltime, small);
+    printf("runtime:    %.6f s\n", runtime);
+    printf("throughput: %.6f Mnodes/s\n", nodes * 0.000001 / runtime);
+    printf("throughput: %.6f Medges/s\n", edges * 0.000001 / runtime);
+  }
+
+  // the same checks as the serial verification, each rank covers its own vertices against the final ghost colors
+  long long bad[3] = {0, -1, -1};  // conflicts, first offending vertex and neighbor (global IDs)
+  int cols = -1;
+  for (int v = 0; v < p.locals; v++) {
+    cols = std::max(cols, color[v]);
+    if (color[v] < 0) {
+      if (bad[0]++ == 0) {bad[1] = p.lo + v;  bad[2] = -1;}
+    }
+    for (ECLedge i = p.nidx[v]; i < p.nidx[v + 1]; i++) {
+      if (color[p.nlist[i]] == color[v]) {
+        if (bad[0]++ == 0) {bad[1] = p.lo + v;  bad[2] = globalID(p, p.nlist[i]);}
+      }
+    }
+  }
+  std::vector<long long> allbad(3 * ranks);
+  MPI_Gather(bad, 3, MPI_LONG_LONG, allbad.data(), 3, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &cols, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (rank == 0) {
+    for (int r = 0; r < ranks; r++) {
+      if (allbad[3 * r] > 0) {
+        if (allbad[3 * r + 2] < 0) {printf("ERROR: found unprocessed node in graph (node %lld on rank %d)\n\n", allbad[3 * r + 1], r);  MPI_Abort(MPI_COMM_WORLD, -1);}
+        printf("ERROR: found adjacent nodes with same color (%lld %lld on rank %d)\n\n", allbad[3 * r + 1], allbad[3 * r + 2], r);  MPI_Abort(MPI_COMM_WORLD, -1);
+      }
+    }
+    printf("result verification passed\n");
+    printf("colors used: %d\n", cols + 1);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
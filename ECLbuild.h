@@ -0,0 +1,547 @@
+#ifndef ECL_BUILD
+#define ECL_BUILD
+
+#include <algorithm>
+#include <cstring>
+#include "ECLgraph.h"
+
+
+// parallel exclusive prefix sum over a[0..n), returns the total
+template <typename T>
+inline T prefixSumECL(T* const a, const long long n, const int threads)
+{
+  const int blocks = threads * 4;
+  T* const part = new T [blocks + 1];
+  #pragma omp parallel for num_threads(threads) default(none) shared(a, n, blocks, part) schedule(static, 1)
+  for (int b = 0; b < blocks; b++) {
+    const long long beg = n * b / blocks;
+    const long long end = n * (b + 1) / blocks;
+    T sum = 0;
+    for (long long i = beg; i < end; i++) sum += a[i];
+    part[b + 1] = sum;
+  }
+  part[0] = 0;
+  for (int b = 0; b < blocks; b++) part[b + 1] += part[b];
+  #pragma omp parallel for num_threads(threads) default(none) shared(a, n, blocks, part) schedule(static, 1)
+  for (int b = 0; b < blocks; b++) {
+    const long long beg = n * b / blocks;
+    const long long end = n * (b + 1) / blocks;
+    T sum = part[b];
+    for (long long i = beg; i < end; i++) {
+      const T val = a[i];
+      a[i] = sum;
+      sum += val;
+    }
+  }
+  const T total = part[blocks];
+  delete [] part;
+  return total;
+}
+
+
+// text edge lists (SNAP or MatrixMarket coordinate format)
+struct ECLtext {
+  const char* data;  // mapped file
+  size_t size;
+  size_t body;  // offset of the first edge line
+  int nodes;  // -1 if the header does not say
+  long long entries;  // edge lines announced by the header (-1 if unknown)
+  int base;  // 0 for SNAP, 1 for MatrixMarket
+  bool mirror;  // symmetric MatrixMarket file: every entry stands for both directions
+};
+
+inline const char* nextECLline(const char* p, const char* const end)
+{
+  const char* const nl = (const char*)memchr(p, '\n', end - p);
+  return (nl == NULL) ? end : (nl + 1);
+}
+
+inline ECLtext openECLtext(const char* const fname)
+{
+  ECLtext t;
+  const int fd = open(fname, O_RDONLY);  if (fd < 0) {fprintf(stderr, "ERROR: could not open input file %s\n\n", fname);  exit(-1);}
+  struct stat st;
+  if (fstat(fd, &st) != 0) {fprintf(stderr, "ERROR: could not stat input file %s\n\n", fname);  exit(-1);}
+  t.size = st.st_size;
+  if (t.size == 0) {fprintf(stderr, "ERROR: input file %s is empty\n\n", fname);  exit(-1);}
+  void* const map = mmap(NULL, t.size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {fprintf(stderr, "ERROR: could not map input file %s\n\n", fname);  exit(-1);}
+  madvise(map, t.size, MADV_SEQUENTIAL);
+  t.data = (const char*)map;
+  t.nodes = -1;
+  t.entries = -1;
+  t.mirror = false;
+
+  const char* const end = t.data + t.size;
+  const char* p = t.data;
+  char line[256];
+  if ((t.size >= 14) && (strncmp(t.data, "%%MatrixMarket", 14) == 0)) {
+    t.base = 1;
+    const char* q = nextECLline(p, end);
+    const size_t len = std::min((size_t)(q - p), sizeof(line) - 1);
+    memcpy(line, p, len);
+    line[len] = 0;
+    char object[64], format[64], field[64], symmetry[64];
+    if ((sscanf(line, "%%%%MatrixMarket %63s %63s %63s %63s", object, format, field, symmetry) != 4) || (strcmp(object, "matrix") != 0) || (strcmp(format, "coordinate") != 0)) {fprintf(stderr, "ERROR: only MatrixMarket coordinate matrices are supported\n\n");  exit(-1);}
+    if ((strcmp(symmetry, "integer") == 0) || (strcmp(symmetry, "real") == 0) || (strcmp(symmetry, "pattern") == 0)) std::swap(field, symmetry);  // graph.cpp writes "general integer"
+    if (strcmp(field, "complex") == 0) {fprintf(stderr, "ERROR: complex MatrixMarket matrices are not supported\n\n");  exit(-1);}
+    t.mirror = (strcmp(symmetry, "general") != 0);
+    p = q;
+    while ((p < end) && (*p == '%')) p = nextECLline(p, end);
+    q = nextECLline(p, end);
+    const size_t len2 = std::min((size_t)(q - p), sizeof(line) - 1);
+    memcpy(line, p, len2);
+    line[len2] = 0;
+    long long rows, cols, nnz;
+    if ((sscanf(line, "%lld %lld %lld", &rows, &cols, &nnz) != 3) || (rows < 1) || (cols < 1) || (nnz < 0) || (std::max(rows, cols) > INT_MAX)) {fprintf(stderr, "ERROR: failed to parse MatrixMarket size line\n\n");  exit(-1);}
+    t.nodes = std::max(rows, cols);
+    t.entries = nnz;
+    p = q;
+  } else {
+    t.base = 0;
+    while ((p < end) && (*p == '#')) {
+      const char* const q = nextECLline(p, end);
+      const size_t len = std::min((size_t)(q - p), sizeof(line) - 1);
+      memcpy(line, p, len);
+      line[len] = 0;
+      const char* const n = strstr(line, "Nodes:");
+      const char* const e = strstr(line, "Edges:");
+      if ((n != NULL) && (e != NULL)) {
+        long long nodes, edges;
+        if ((sscanf(n + 6, "%lld", &nodes) != 1) || (sscanf(e + 6, "%lld", &edges) != 1) || (nodes < 1) || (nodes > INT_MAX) || (edges < 0)) {fprintf(stderr, "ERROR: failed to parse nodes and edge counts\n\n");  exit(-1);}
+        t.nodes = nodes;
+        t.entries = edges;
+      }
+      p = q;
+    }
+  }
+  t.body = p - t.data;
+  return t;
+}
+
+inline void closeECLtext(ECLtext& t)
+{
+  munmap((void*)t.data, t.size);
+  t.data = NULL;
+}
+
+// byte range of chunk c out of chunks, aligned to line starts
+inline void chunkECLtext(const ECLtext& t, const int c, const int chunks, const char*& beg, const char*& end)
+{
+  const char* const first = t.data + t.body;
+  const char* const last = t.data + t.size;
+  const size_t len = last - first;
+  beg = first + len * c / chunks;
+  end = first + len * (c + 1) / chunks;
+  if (c > 0) beg = nextECLline(beg - 1, last);
+  if (c < chunks - 1) end = nextECLline(end - 1, last);
+}
+
+// hand-rolled parser for the edge lines in [p, end): calls f(src, dst) with zero-based IDs for each line,
+// skips comments and any columns after the second one, and returns false on malformed input
+template <typename F>
+inline bool parseECLedges(const char* p, const char* const end, const int base, F f)
+{
+  while (p < end) {
+    const char c = *p;
+    if ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n')) {p++; continue;}
+    if ((c == '#') || (c == '%')) {p = nextECLline(p, end); continue;}
+    long long val[2];
+    for (int k = 0; k < 2; k++) {
+      while ((p < end) && ((*p == ' ') || (*p == '\t'))) p++;
+      if ((p == end) || (*p < '0') || (*p > '9')) return false;
+      long long v = 0;
+      do {
+        v = v * 10 + (*p - '0');
+        if (v > (long long)INT_MAX + 1) return false;
+        p++;
+      } while ((p < end) && (*p >= '0') && (*p <= '9'));
+      val[k] = v - base;
+    }
+    p = nextECLline(p, end);
+    if ((val[0] < 0) || (val[1] < 0)) return false;
+    f(val[0], val[1]);
+  }
+  return true;
+}
+
+// converts a SNAP or MatrixMarket edge list into CSR using several parsing threads and a counting sort
+// (one pass to count degrees, one to scatter the neighbors); adjacency lists come out sorted
+inline ECLgraph convertECLtext(const char* const fname, const int threads)
+{
+  ECLtext t = openECLtext(fname);
+  const int chunks = threads * 8;
+  bool ok = true;
+
+  if (t.nodes < 0) {
+    long long maxid = -1;
+    #pragma omp parallel for num_threads(threads) default(none) shared(t, chunks) reduction(max: maxid) reduction(&&: ok) schedule(dynamic, 1)
+    for (int c = 0; c < chunks; c++) {
+      const char *beg, *end;
+      chunkECLtext(t, c, chunks, beg, end);
+      ok = parseECLedges(beg, end, t.base, [&](const long long src, const long long dst) {maxid = std::max(maxid, std::max(src, dst));}) && ok;
+    }
+    if (!ok) {fprintf(stderr, "ERROR: malformed edge line\n\n");  exit(-1);}
+    if ((maxid < 0) || (maxid >= INT_MAX)) {fprintf(stderr, "ERROR: could not determine node count\n\n");  exit(-1);}
+    t.nodes = maxid + 1;
+  }
+
+  ECLgraph g;
+  g.nodes = t.nodes;
+  g.nindex = (ECLedge*)calloc(g.nodes + 1, sizeof(g.nindex[0]));
+  g.eweight = NULL;
+  g.map = NULL;
+  g.mapsize = 0;
+  if (g.nindex == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+
+  // pass 1: degree histogram (counted at nindex[src + 1])
+  const int nodes = g.nodes;
+  ECLedge* const nidx = g.nindex;
+  long long entries = 0;
+  bool inrange = true;
+  #pragma omp parallel for num_threads(threads) default(none) shared(t, chunks, nodes, nidx) reduction(+: entries) reduction(&&: ok, inrange) schedule(dynamic, 1)
+  for (int c = 0; c < chunks; c++) {
+    const char *beg, *end;
+    chunkECLtext(t, c, chunks, beg, end);
+    ok = parseECLedges(beg, end, t.base, [&](const long long src, const long long dst) {
+      entries++;
+      if ((src >= nodes) || (dst >= nodes)) {inrange = false; return;}
+      #pragma omp atomic
+      nidx[src + 1]++;
+      if (t.mirror && (src != dst)) {
+        #pragma omp atomic
+        nidx[dst + 1]++;
+      }
+    }) && ok;
+  }
+  if (!ok) {fprintf(stderr, "ERROR: malformed edge line\n\n");  exit(-1);}
+  if (!inrange) {fprintf(stderr, "ERROR: node ID out of range\n\n");  exit(-1);}
+  if ((t.entries >= 0) && (entries != t.entries)) {fprintf(stderr, "ERROR: failed to read correct number of edges (%lld instead of %lld)\n\n", entries, t.entries);  exit(-1);}
+
+  const long long edges = prefixSumECL(nidx + 1, nodes, threads);
+  if ((sizeof(ECLedge) < sizeof(long long)) && (edges > INT_MAX)) {fprintf(stderr, "ERROR: graph has more than %d edges, recompile with -DECL_LARGE_EDGES\n\n", INT_MAX);  exit(-1);}
+  g.edges = edges;
+  g.nlist = (int*)malloc(std::max(g.edges, (ECLedge)1) * sizeof(g.nlist[0]));
+  if (g.nlist == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+
+  // pass 2: scatter, using nindex[src + 1] as the insertion cursor of src (it ends up at the end of src's list)
+  int* const nlist = g.nlist;
+  #pragma omp parallel for num_threads(threads) default(none) shared(t, chunks, nidx, nlist) schedule(dynamic, 1)
+  for (int c = 0; c < chunks; c++) {
+    const char *beg, *end;
+    chunkECLtext(t, c, chunks, beg, end);
+    parseECLedges(beg, end, t.base, [&](const long long src, const long long dst) {
+      ECLedge pos;
+      #pragma omp atomic capture
+      pos = nidx[src + 1]++;
+      nlist[pos] = dst;
+      if (t.mirror && (src != dst)) {
+        #pragma omp atomic capture
+        pos = nidx[dst + 1]++;
+        nlist[pos] = src;
+      }
+    });
+  }
+  closeECLtext(t);
+
+  // the scatter order depends on the thread interleaving, so sort each list to make the output deterministic
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, nidx, nlist) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) std::sort(&nlist[nidx[v]], &nlist[nidx[v + 1]]);
+
+  return g;
+}
+
+
+// turns g into an undirected simple graph by adding missing reverse edges and dropping duplicate edges and
+// self-loops (edge weights are dropped); the merged adjacency of each vertex is sorted and deduplicated as a
+// run by whichever thread owns the vertex, and the old neighbor array is reused when it is large enough;
+// returns the number of self-loops removed
+inline long long cleanECLgraph(ECLgraph& g, const int threads)
+{
+  const int nodes = g.nodes;
+  const ECLedge* const nidx = g.nindex;
+  const int* const nlist = g.nlist;
+
+  // count both directions of every non-loop edge (at cnt[v + 1], as in convertECLtext)
+  ECLedge* const cnt = (ECLedge*)calloc(nodes + 1, sizeof(cnt[0]));
+  if (cnt == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  long long loops = 0;
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, nidx, nlist, cnt) reduction(+: loops) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) {
+    ECLedge own = 0;
+    for (ECLedge i = nidx[v]; i < nidx[v + 1]; i++) {
+      const int u = nlist[i];
+      if (u == v) {
+        loops++;
+      } else {
+        own++;
+        #pragma omp atomic
+        cnt[u + 1]++;
+      }
+    }
+    #pragma omp atomic
+    cnt[v + 1] += own;
+  }
+  const long long total = prefixSumECL(cnt + 1, nodes, threads);
+  if ((sizeof(ECLedge) < sizeof(long long)) && (total > INT_MAX)) {fprintf(stderr, "ERROR: symmetrized graph has more than %d edges, recompile with -DECL_LARGE_EDGES\n\n", INT_MAX);  exit(-1);}
+  int* const tmp = (int*)malloc(std::max(total, 1LL) * sizeof(tmp[0]));
+  if (tmp == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, nidx, nlist, cnt, tmp) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) {
+    for (ECLedge i = nidx[v]; i < nidx[v + 1]; i++) {
+      const int u = nlist[i];
+      if (u != v) {
+        ECLedge pos;
+        #pragma omp atomic capture
+        pos = cnt[v + 1]++;
+        tmp[pos] = u;
+        #pragma omp atomic capture
+        pos = cnt[u + 1]++;
+        tmp[pos] = v;
+      }
+    }
+  }
+
+  // sorted, duplicate-free runs; their lengths go to nidx2[v] and become offsets through the prefix sum
+  ECLedge* const nidx2 = (ECLedge*)malloc((nodes + 1) * sizeof(nidx2[0]));
+  if (nidx2 == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, cnt, tmp, nidx2) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) {
+    int* const beg = &tmp[cnt[v]];
+    int* const end = &tmp[cnt[v + 1]];
+    std::sort(beg, end);
+    nidx2[v] = std::unique(beg, end) - beg;
+  }
+  nidx2[nodes] = 0;
+  const ECLedge edges = prefixSumECL(nidx2, nodes + 1, threads);
+
+  // the old neighbor array is dead after the scatter, so reuse it if it is ours and big enough
+  const bool reuse = (g.map == NULL) && (edges <= g.edges);
+  int* const nlist2 = reuse ? g.nlist : (int*)malloc(std::max(edges, (ECLedge)1) * sizeof(nlist2[0]));
+  if (nlist2 == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, cnt, tmp, nidx2, nlist2) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) {
+    std::copy(&tmp[cnt[v]], &tmp[cnt[v] + (nidx2[v + 1] - nidx2[v])], &nlist2[nidx2[v]]);
+  }
+  free(tmp);
+  free(cnt);
+
+  if (reuse) {
+    free(g.nindex);
+    if (g.eweight != NULL) free(g.eweight);
+  } else {
+    freeECLgraph(g);
+  }
+  g.edges = edges;
+  g.nindex = nidx2;
+  g.nlist = nlist2;
+  g.eweight = NULL;
+  g.map = NULL;
+  g.mapsize = 0;
+  return loops;
+}
+
+
+// vertex orderings for orderECLgraph
+static const int ECL_ORDER_DEGREE = 1;  // degree descending
+static const int ECL_ORDER_RCM = 2;  // reverse Cuthill-McKee
+static const int ECL_ORDER_COMMUNITY = 3;  // label-propagation communities kept contiguous
+
+// stable counting sort of the vertices by key (0 <= key[v] < keys), writes perm[v] = new ID of v
+inline void countingOrderECL(const int nodes, const int* const key, const int keys, int* const perm)
+{
+  int* const pos = (int*)calloc(keys + 1, sizeof(pos[0]));
+  if (pos == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  for (int v = 0; v < nodes; v++) pos[key[v] + 1]++;
+  for (int k = 0; k < keys; k++) pos[k + 1] += pos[k];
+  for (int v = 0; v < nodes; v++) perm[v] = pos[key[v]]++;
+  free(pos);
+}
+
+inline void rcmOrderECL(const ECLgraph& g, int* const perm)
+{
+  const int nodes = g.nodes;
+  const ECLedge* const nidx = g.nindex;
+  int* const deg = new int [nodes];
+  int maxdeg = 0;
+  for (int v = 0; v < nodes; v++) {
+    deg[v] = nidx[v + 1] - nidx[v];
+    maxdeg = std::max(maxdeg, deg[v]);
+  }
+  // start each component at its lowest-degree vertex
+  int* const start = new int [nodes];
+  countingOrderECL(nodes, deg, maxdeg + 1, perm);
+  for (int v = 0; v < nodes; v++) start[perm[v]] = v;
+
+  int* const queue = new int [nodes];
+  bool* const seen = new bool [nodes];
+  for (int v = 0; v < nodes; v++) seen[v] = false;
+  int head = 0, tail = 0;
+  for (int s = 0; s < nodes; s++) {
+    const int root = start[s];
+    if (seen[root]) continue;
+    seen[root] = true;
+    queue[tail++] = root;
+    while (head < tail) {
+      const int v = queue[head++];
+      const int first = tail;
+      for (ECLedge i = nidx[v]; i < nidx[v + 1]; i++) {
+        const int u = g.nlist[i];
+        if (!seen[u]) {
+          seen[u] = true;
+          queue[tail++] = u;
+        }
+      }
+      std::sort(&queue[first], &queue[tail], [&](const int a, const int b) {return (deg[a] < deg[b]) || ((deg[a] == deg[b]) && (a < b));});
+    }
+  }
+  for (int i = 0; i < nodes; i++) perm[queue[i]] = nodes - 1 - i;
+  delete [] deg;
+  delete [] start;
+  delete [] queue;
+  delete [] seen;
+}
+
+inline void communityOrderECL(const ECLgraph& g, int* const perm, const int threads)
+{
+  const int nodes = g.nodes;
+  const ECLedge* const nidx = g.nindex;
+  const int* const nlist = g.nlist;
+  int* const label = new int [nodes];
+  #pragma omp parallel for num_threads(threads) default(none) shared(nodes, label)
+  for (int v = 0; v < nodes; v++) label[v] = v;
+
+  // asynchronous label propagation: adopt the most frequent neighbor label (smallest on ties)
+  const int rounds = 5;
+  for (int r = 0; r < rounds; r++) {
+    int changed = 0;
+    #pragma omp parallel num_threads(threads) default(none) shared(nodes, nidx, nlist, label) reduction(+: changed)
+    {
+      int cap = 64;
+      int* buf = new int [cap];
+      #pragma omp for schedule(dynamic, 1024)
+      for (int v = 0; v < nodes; v++) {
+        const int deg = nidx[v + 1] - nidx[v];
+        if (deg == 0) continue;
+        if (deg > cap) {
+          delete [] buf;
+          cap = deg;
+          buf = new int [cap];
+        }
+        for (int j = 0; j < deg; j++) {
+          int lab;
+          #pragma omp atomic read
+          lab = label[nlist[nidx[v] + j]];
+          buf[j] = lab;
+        }
+        std::sort(buf, buf + deg);
+        int best = buf[0], bestcnt = 0;
+        for (int j = 0; j < deg; ) {
+          int k = j + 1;
+          while ((k < deg) && (buf[k] == buf[j])) k++;
+          if (k - j > bestcnt) {
+            best = buf[j];
+            bestcnt = k - j;
+          }
+          j = k;
+        }
+        if (best != label[v]) {
+          #pragma omp atomic write
+          label[v] = best;
+          changed++;
+        }
+      }
+      delete [] buf;
+    }
+    if (changed == 0) break;
+  }
+  countingOrderECL(nodes, label, nodes, perm);
+  delete [] label;
+}
+
+// computes a relabeling perm[old ID] = new ID that improves the locality of the neighbor accesses
+inline void orderECLgraph(const ECLgraph& g, const int method, int* const perm, const int threads)
+{
+  const int nodes = g.nodes;
+  if (method == ECL_ORDER_DEGREE) {
+    int* const key = new int [nodes];
+    int maxdeg = 0;
+    #pragma omp parallel for num_threads(threads) default(none) shared(g, nodes, key) reduction(max: maxdeg)
+    for (int v = 0; v < nodes; v++) {
+      key[v] = g.nindex[v + 1] - g.nindex[v];
+      maxdeg = std::max(maxdeg, key[v]);
+    }
+    #pragma omp parallel for num_threads(threads) default(none) shared(nodes, key, maxdeg)
+    for (int v = 0; v < nodes; v++) key[v] = maxdeg - key[v];
+    countingOrderECL(nodes, key, maxdeg + 1, perm);
+    delete [] key;
+  } else if (method == ECL_ORDER_RCM) {
+    rcmOrderECL(g, perm);
+  } else if (method == ECL_ORDER_COMMUNITY) {
+    communityOrderECL(g, perm, threads);
+  } else {
+    fprintf(stderr, "ERROR: unknown vertex ordering %d\n\n", method);  exit(-1);
+  }
+}
+
+// returns a copy of g with vertex v renamed to perm[v] (adjacency lists sorted, edge weights dropped)
+inline ECLgraph permuteECLgraph(const ECLgraph& g, const int* const perm, const int threads)
+{
+  const int nodes = g.nodes;
+  ECLgraph h;
+  h.nodes = nodes;
+  h.edges = g.edges;
+  h.nindex = (ECLedge*)malloc((nodes + 1) * sizeof(h.nindex[0]));
+  h.nlist = (int*)malloc(std::max(g.edges, (ECLedge)1) * sizeof(h.nlist[0]));
+  h.eweight = NULL;
+  h.map = NULL;
+  h.mapsize = 0;
+  if ((h.nindex == NULL) || (h.nlist == NULL)) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+
+  ECLedge* const nidx = h.nindex;
+  int* const nlist = h.nlist;
+  #pragma omp parallel for num_threads(threads) default(none) shared(g, nodes, perm, nidx)
+  for (int v = 0; v < nodes; v++) nidx[perm[v]] = g.nindex[v + 1] - g.nindex[v];
+  nidx[nodes] = 0;
+  prefixSumECL(nidx, nodes + 1, threads);
+  #pragma omp parallel for num_threads(threads) default(none) shared(g, nodes, perm, nidx, nlist) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) {
+    ECLedge pos = nidx[perm[v]];
+    for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) nlist[pos++] = perm[g.nlist[i]];
+    std::sort(&nlist[nidx[perm[v]]], &nlist[pos]);
+  }
+  return h;
+}
+
+
+// returns a heap copy of g whose pages are first touched by the threads that later process the same
+// vertices under the static vertex partition of the coloring kernels (schedule(static) over all nodes),
+// so on NUMA machines each thread's part of the CSR lands on its own node when the threads are pinned
+inline ECLgraph firstTouchECLgraph(const ECLgraph& g, const int threads)
+{
+  const int nodes = g.nodes;
+  ECLgraph h;
+  h.nodes = nodes;
+  h.edges = g.edges;
+  h.nindex = (ECLedge*)malloc((nodes + 1) * sizeof(h.nindex[0]));
+  h.nlist = (int*)malloc(std::max(g.edges, (ECLedge)1) * sizeof(h.nlist[0]));
+  h.eweight = (g.eweight == NULL) ? NULL : (int*)malloc(std::max(g.edges, (ECLedge)1) * sizeof(h.eweight[0]));
+  h.map = NULL;
+  h.mapsize = 0;
+  if ((h.nindex == NULL) || (h.nlist == NULL) || ((g.eweight != NULL) && (h.eweight == NULL))) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+
+  ECLedge* const nidx = h.nindex;
+  int* const nlist = h.nlist;
+  int* const eweight = h.eweight;
+  #pragma omp parallel for num_threads(threads) default(none) shared(g, nodes, nidx, nlist, eweight) schedule(static)
+  for (int v = 0; v < nodes; v++) {
+    nidx[v + 1] = g.nindex[v + 1];
+    std::copy(&g.nlist[g.nindex[v]], &g.nlist[g.nindex[v + 1]], &nlist[g.nindex[v]]);
+    if (eweight != NULL) std::copy(&g.eweight[g.nindex[v]], &g.eweight[g.nindex[v + 1]], &eweight[g.nindex[v]]);
+  }
+  nidx[0] = g.nindex[0];
+  return h;
+}
+
+#endif
@@ -3,31 +3,112 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// node IDs are always 32 bits wide, edge offsets are 64 bits wide when compiled with -DECL_LARGE_EDGES
+#ifdef ECL_LARGE_EDGES
+typedef long long ECLedge;
+#else
+typedef int ECLedge;
+#endif
 
 struct ECLgraph {
   int nodes;
-  int edges;
-  int* nindex;
+  ECLedge edges;
+  ECLedge* nindex;
   int* nlist;
   int* eweight;
+  void* map;  // file mapping the arrays point into (NULL if they are heap allocated)
+  size_t mapsize;
+};
+
+// hints for mapECLgraph
+static const int ECL_MAP_POPULATE = 1;  // prefault all pages up front (MAP_POPULATE)
+static const int ECL_MAP_HUGEPAGES = 2;  // ask for transparent huge pages (MADV_HUGEPAGE)
+
+// .egr layouts:
+//   version 1 (legacy): int nodes, int edges, int nindex[nodes + 1], int nlist[edges], optional int eweight[edges]
+//   version 2: int magic, int version, int nodes, int offset bytes (8), long long edges, long long nindex[nodes + 1], int nlist[edges], optional int eweight[edges]
+// the magic value is negative, so it can never be mistaken for the node count of a version-1 file
+static const int ECL_MAGIC = (int)0xEC16E64A;
+static const int ECL_VERSION = 2;
+
+struct ECLheader {
+  int nodes;
+  long long edges;
+  bool wide;  // nindex stored as long long
+  size_t size;  // header size in bytes
 };
 
-ECLgraph readECLgraph(const char* const fname)
+inline ECLheader parseECLheader(const int* const hdr, const size_t avail)
+{
+  ECLheader h;
+  if (avail < 2 * sizeof(int)) {fprintf(stderr, "ERROR: failed to read nodes and edges\n\n");  exit(-1);}
+  if (hdr[0] == ECL_MAGIC) {
+    if ((avail < 4 * sizeof(int) + sizeof(long long)) || (hdr[1] != ECL_VERSION) || (hdr[3] != sizeof(long long))) {fprintf(stderr, "ERROR: unsupported .egr header\n\n");  exit(-1);}
+    h.nodes = hdr[2];
+    h.edges = *(const long long*)(hdr + 4);
+    h.wide = true;
+    h.size = 4 * sizeof(int) + sizeof(long long);
+  } else {
+    h.nodes = hdr[0];
+    h.edges = hdr[1];
+    h.wide = false;
+    h.size = 2 * sizeof(int);
+  }
+  if ((h.nodes < 1) || (h.edges < 0)) {fprintf(stderr, "ERROR: node or edge count too low\n\n");  exit(-1);}
+  if ((sizeof(ECLedge) < sizeof(long long)) && (h.edges > INT_MAX)) {fprintf(stderr, "ERROR: graph has more than %d edges, recompile with -DECL_LARGE_EDGES\n\n", INT_MAX);  exit(-1);}
+  return h;
+}
+
+// copies count offsets of the given on-disk width into nindex, converting between 32 and 64 bits as needed
+inline void convertECLoffsets(ECLedge* const nindex, const void* const src, const int count, const bool wide)
+{
+  if (wide) {
+    const long long* const s = (const long long*)src;
+    for (int i = 0; i < count; i++) nindex[i] = s[i];
+  } else {
+    const int* const s = (const int*)src;
+    for (int i = 0; i < count; i++) nindex[i] = s[i];
+  }
+}
+
+inline ECLgraph readECLgraph(const char* const fname)
 {
   ECLgraph g;
-  int cnt;
+  ECLedge cnt;
+  g.map = NULL;
+  g.mapsize = 0;
 
   FILE* f = fopen(fname, "rb");  if (f == NULL) {fprintf(stderr, "ERROR: could not open file %s\n\n", fname);  exit(-1);}
-  cnt = fread(&g.nodes, sizeof(g.nodes), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to read nodes\n\n");  exit(-1);}
-  cnt = fread(&g.edges, sizeof(g.edges), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to read edges\n\n");  exit(-1);}
-  if ((g.nodes < 1) || (g.edges < 0)) {fprintf(stderr, "ERROR: node or edge count too low\n\n");  exit(-1);}
+  int hdr[6];
+  cnt = fread(hdr, sizeof(int), 2, f);
+  if ((cnt == 2) && (hdr[0] == ECL_MAGIC)) cnt += fread(hdr + 2, sizeof(int), 4, f);
+  const ECLheader h = parseECLheader(hdr, cnt * sizeof(int));
+  g.nodes = h.nodes;
+  g.edges = h.edges;
 
-  g.nindex = (int*)malloc((g.nodes + 1) * sizeof(g.nindex[0]));
+  g.nindex = (ECLedge*)malloc((g.nodes + 1) * sizeof(g.nindex[0]));
   g.nlist = (int*)malloc(g.edges * sizeof(g.nlist[0]));
   g.eweight = (int*)malloc(g.edges * sizeof(g.eweight[0]));
   if ((g.nindex == NULL) || (g.nlist == NULL) || (g.eweight == NULL)) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
 
-  cnt = fread(g.nindex, sizeof(g.nindex[0]), g.nodes + 1, f);  if (cnt != g.nodes + 1) {fprintf(stderr, "ERROR: failed to read neighbor index list\n\n");  exit(-1);}
+  const size_t offsize = h.wide ? sizeof(long long) : sizeof(int);
+  if (offsize == sizeof(g.nindex[0])) {
+    cnt = fread(g.nindex, sizeof(g.nindex[0]), g.nodes + 1, f);  if (cnt != g.nodes + 1) {fprintf(stderr, "ERROR: failed to read neighbor index list\n\n");  exit(-1);}
+  } else {
+    const int chunk = 4096;
+    long long buf[chunk];
+    for (int i = 0; i < g.nodes + 1; i += chunk) {
+      const int num = (g.nodes + 1 - i < chunk) ? (g.nodes + 1 - i) : chunk;
+      cnt = fread(buf, offsize, num, f);  if (cnt != num) {fprintf(stderr, "ERROR: failed to read neighbor index list\n\n");  exit(-1);}
+      convertECLoffsets(&g.nindex[i], buf, num, h.wide);
+    }
+  }
   cnt = fread(g.nlist, sizeof(g.nlist[0]), g.edges, f);  if (cnt != g.edges) {fprintf(stderr, "ERROR: failed to read neighbor list\n\n");  exit(-1);}
   cnt = fread(g.eweight, sizeof(g.eweight[0]), g.edges, f);
   if (cnt == 0) {
@@ -41,13 +122,73 @@ ECLgraph readECLgraph(const char* const fname)
   return g;
 }
 
-void writeECLgraph(const ECLgraph g, const char* const fname)
+// zero-copy alternative to readECLgraph: the returned arrays point straight into a private
+// (copy-on-write) mapping of the file, so loading time does not depend on the graph size
+// (only nindex is copied if the file's offset width differs from ECLedge)
+inline ECLgraph mapECLgraph(const char* const fname, const int flags = 0)
+{
+  ECLgraph g;
+
+  const int fd = open(fname, O_RDONLY);  if (fd < 0) {fprintf(stderr, "ERROR: could not open file %s\n\n", fname);  exit(-1);}
+  struct stat st;
+  if (fstat(fd, &st) != 0) {fprintf(stderr, "ERROR: could not stat file %s\n\n", fname);  exit(-1);}
+  const size_t size = st.st_size;
+  if (size < 2 * sizeof(int)) {fprintf(stderr, "ERROR: failed to read nodes and edges\n\n");  exit(-1);}
+
+  int mflags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+  if (flags & ECL_MAP_POPULATE) mflags |= MAP_POPULATE;
+#endif
+  void* const map = mmap(NULL, size, PROT_READ | PROT_WRITE, mflags, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {fprintf(stderr, "ERROR: could not map file %s\n\n", fname);  exit(-1);}
+#ifdef MADV_HUGEPAGE
+  if (flags & ECL_MAP_HUGEPAGES) madvise(map, size, MADV_HUGEPAGE);
+#endif
+
+  const ECLheader h = parseECLheader((const int*)map, size);
+  g.nodes = h.nodes;
+  g.edges = h.edges;
+  const size_t offsize = h.wide ? sizeof(long long) : sizeof(int);
+  const size_t listsize = (size_t)g.edges * sizeof(int);
+  const size_t need = h.size + (g.nodes + 1) * offsize + listsize;
+  if (size < need) {fprintf(stderr, "ERROR: file too short for node and edge counts\n\n");  exit(-1);}
+
+  char* const offsets = (char*)map + h.size;
+  if (offsize == sizeof(g.nindex[0])) {
+    g.nindex = (ECLedge*)offsets;
+  } else {
+    g.nindex = (ECLedge*)malloc((g.nodes + 1) * sizeof(g.nindex[0]));
+    if (g.nindex == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+    convertECLoffsets(g.nindex, offsets, g.nodes + 1, h.wide);
+  }
+  g.nlist = (int*)(offsets + (g.nodes + 1) * offsize);
+  g.eweight = NULL;
+  if (size > need) {
+    if (size < need + listsize) {fprintf(stderr, "ERROR: failed to read edge weights\n\n");  exit(-1);}
+    if (g.edges > 0) g.eweight = g.nlist + g.edges;
+  }
+  g.map = map;
+  g.mapsize = size;
+
+  return g;
+}
+
+// writes the legacy format when edge offsets are 32 bits wide and the versioned format otherwise
+inline void writeECLgraph(const ECLgraph g, const char* const fname)
 {
   if ((g.nodes < 1) || (g.edges < 0)) {fprintf(stderr, "ERROR: node or edge count too low\n\n");  exit(-1);}
-  int cnt;
+  ECLedge cnt;
   FILE* f = fopen(fname, "wb");  if (f == NULL) {fprintf(stderr, "ERROR: could not open file %s\n\n", fname);  exit(-1);}
-  cnt = fwrite(&g.nodes, sizeof(g.nodes), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to write nodes\n\n");  exit(-1);}
-  cnt = fwrite(&g.edges, sizeof(g.edges), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to write edges\n\n");  exit(-1);}
+  if (sizeof(g.nindex[0]) == sizeof(long long)) {
+    const int hdr[4] = {ECL_MAGIC, ECL_VERSION, g.nodes, (int)sizeof(long long)};
+    const long long edges = g.edges;
+    cnt = fwrite(hdr, sizeof(hdr[0]), 4, f);  if (cnt != 4) {fprintf(stderr, "ERROR: failed to write header\n\n");  exit(-1);}
+    cnt = fwrite(&edges, sizeof(edges), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to write edges\n\n");  exit(-1);}
+  } else {
+    cnt = fwrite(&g.nodes, sizeof(g.nodes), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to write nodes\n\n");  exit(-1);}
+    cnt = fwrite(&g.edges, sizeof(g.edges), 1, f);  if (cnt != 1) {fprintf(stderr, "ERROR: failed to write edges\n\n");  exit(-1);}
+  }
 
   cnt = fwrite(g.nindex, sizeof(g.nindex[0]), g.nodes + 1, f);  if (cnt != g.nodes + 1) {fprintf(stderr, "ERROR: failed to write neighbor index list\n\n");  exit(-1);}
   cnt = fwrite(g.nlist, sizeof(g.nlist[0]), g.edges, f);  if (cnt != g.edges) {fprintf(stderr, "ERROR: failed to write neighbor list\n\n");  exit(-1);}
@@ -57,11 +198,20 @@ void writeECLgraph(const ECLgraph g, const char* const fname)
   fclose(f);
 }
 
-void freeECLgraph(ECLgraph &g)
+inline void freeECLgraph(ECLgraph &g)
 {
-  if (g.nindex != NULL) free(g.nindex);
-  if (g.nlist != NULL) free(g.nlist);
-  if (g.eweight != NULL) free(g.eweight);
+  if (g.map != NULL) {
+    const char* const beg = (const char*)g.map;
+    const char* const ptr = (const char*)g.nindex;
+    if ((ptr < beg) || (ptr >= beg + g.mapsize)) free(g.nindex);  // converted copy
+    munmap(g.map, g.mapsize);
+  } else {
+    if (g.nindex != NULL) free(g.nindex);
+    if (g.nlist != NULL) free(g.nlist);
+    if (g.eweight != NULL) free(g.eweight);
+  }
+  g.map = NULL;
+  g.mapsize = 0;
   g.nindex = NULL;
   g.nlist = NULL;
   g.eweight = NULL;
@@ -0,0 +1,231 @@
+#ifndef ECL_RECOLOR
+#define ECL_RECOLOR
+
+#include <algorithm>
+#include <vector>
+#include "ECLbuild.h"
+
+
+// batched graph changes for applyECLupdates and recolorECLgraph (edges are undirected)
+static const int ECL_INSERT_EDGE = 0;
+static const int ECL_DELETE_EDGE = 1;
+static const int ECL_INSERT_VERTEX = 2;  // dst is ignored
+static const int ECL_DELETE_VERTEX = 3;  // removes all edges of src, the (isolated) vertex keeps its ID
+
+struct ECLupdate {
+  int type;
+  int src;
+  int dst;
+};
+
+// reads lines "+ u v" (insert edge), "- u v" (delete edge), "+ v" (insert vertex) and "- v" (delete vertex)
+inline std::vector<ECLupdate> readECLupdates(const char* const fname)
+{
+  FILE* f = fopen(fname, "rt");  if (f == NULL) {fprintf(stderr, "ERROR: could not open file %s\n\n", fname);  exit(-1);}
+  std::vector<ECLupdate> upd;
+  char line[256];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    char op;
+    int src, dst;
+    const int cnt = sscanf(line, " %c %d %d", &op, &src, &dst);
+    if ((cnt < 1) || (op == '#')) continue;
+    if (((op != '+') && (op != '-')) || (cnt < 2) || (src < 0) || ((cnt == 3) && (dst < 0))) {fprintf(stderr, "ERROR: malformed update line %s\n", line);  exit(-1);}
+    ECLupdate u;
+    u.type = (cnt == 3) ? ((op == '+') ? ECL_INSERT_EDGE : ECL_DELETE_EDGE) : ((op == '+') ? ECL_INSERT_VERTEX : ECL_DELETE_VERTEX);
+    u.src = src;
+    u.dst = (cnt == 3) ? dst : -1;
+    upd.push_back(u);
+  }
+  fclose(f);
+  return upd;
+}
+
+
+// same hash and vertex priority as the DAG built by init in ECL-GC_12.cpp: true if u is colored before v
+inline unsigned int hashECL(unsigned int val)
+{
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  val = ((val >> 16) ^ val) * 0x45d9f3b;
+  return (val >> 16) ^ val;
+}
+
+inline bool priorityECL(const ECLedge* const nidx, const int u, const int v)
+{
+  const int degu = nidx[u + 1] - nidx[u];
+  const int degv = nidx[v + 1] - nidx[v];
+  return (degv < degu) || ((degv == degu) && (hashECL(v) < hashECL(u))) || ((degv == degu) && (hashECL(v) == hashECL(u)) && (v < u));
+}
+
+
+struct ECLchange {
+  int src, dst;
+  int seq;  // position in the batch, later changes to the same edge win
+  bool insert;
+};
+
+// applies the batch to g (the node count grows to cover inserted vertices and edge endpoints); only the adjacency
+// lists of touched vertices are merged with their changes, the rest of the CSR is copied in parallel (edge weights are dropped)
+inline void applyECLupdates(ECLgraph& g, const ECLupdate* const upd, const int count, const int threads)
+{
+  std::vector<ECLchange> ch;
+  int nodes = g.nodes;
+  for (int k = 0; k < count; k++) {
+    const ECLupdate& u = upd[k];
+    if (u.type == ECL_INSERT_EDGE) {
+      if (u.src == u.dst) continue;
+      nodes = std::max(nodes, std::max(u.src, u.dst) + 1);
+      ch.push_back({u.src, u.dst, k, true});
+      ch.push_back({u.dst, u.src, k, true});
+    } else if (u.type == ECL_DELETE_EDGE) {
+      ch.push_back({u.src, u.dst, k, false});
+      ch.push_back({u.dst, u.src, k, false});
+    } else if (u.type == ECL_INSERT_VERTEX) {
+      nodes = std::max(nodes, u.src + 1);
+    } else if (u.type == ECL_DELETE_VERTEX) {
+      if (u.src < g.nodes) {
+        for (ECLedge i = g.nindex[u.src]; i < g.nindex[u.src + 1]; i++) {
+          ch.push_back({u.src, g.nlist[i], k, false});
+          ch.push_back({g.nlist[i], u.src, k, false});
+        }
+      }
+    }
+  }
+  std::sort(ch.begin(), ch.end(), [](const ECLchange& a, const ECLchange& b) {return (a.src < b.src) || ((a.src == b.src) && ((a.dst < b.dst) || ((a.dst == b.dst) && (a.seq < b.seq))));});
+
+  // new adjacency lists of the touched vertices
+  std::vector<int> touched;
+  std::vector<size_t> first;
+  for (size_t k = 0; k < ch.size(); k++) {
+    if ((k == 0) || (ch[k].src != ch[k - 1].src)) {
+      touched.push_back(ch[k].src);
+      first.push_back(k);
+    }
+  }
+  first.push_back(ch.size());
+  const int num = touched.size();
+  std::vector<std::vector<int>> lists(num);
+  #pragma omp parallel for num_threads(threads) default(none) shared(g, ch, touched, first, lists, num) schedule(dynamic, 1)
+  for (int t = 0; t < num; t++) {
+    const int v = touched[t];
+    std::vector<int> old;
+    if (v < g.nodes) old.assign(&g.nlist[g.nindex[v]], &g.nlist[g.nindex[v + 1]]);
+    std::sort(old.begin(), old.end());
+    std::vector<int>& res = lists[t];
+    size_t i = 0;
+    for (size_t k = first[t]; k < first[t + 1]; k++) {
+      if ((k + 1 < first[t + 1]) && (ch[k + 1].dst == ch[k].dst)) continue;  // superseded by a later change
+      const int d = ch[k].dst;
+      while ((i < old.size()) && (old[i] < d)) res.push_back(old[i++]);
+      while ((i < old.size()) && (old[i] == d)) i++;
+      if (ch[k].insert) res.push_back(d);
+    }
+    while (i < old.size()) res.push_back(old[i++]);
+  }
+
+  int* const slot = new int [nodes];
+  ECLedge* const nidx = (ECLedge*)malloc((nodes + 1) * sizeof(nidx[0]));
+  if (nidx == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  #pragma omp parallel for num_threads(threads) default(none) shared(g, nodes, slot, nidx)
+  for (int v = 0; v < nodes; v++) {
+    slot[v] = -1;
+    nidx[v] = (v < g.nodes) ? (g.nindex[v + 1] - g.nindex[v]) : 0;
+  }
+  for (int t = 0; t < num; t++) {
+    slot[touched[t]] = t;
+    nidx[touched[t]] = lists[t].size();
+  }
+  nidx[nodes] = 0;
+  const long long edges = prefixSumECL(nidx, nodes + 1, threads);
+  if ((sizeof(ECLedge) < sizeof(long long)) && (edges > INT_MAX)) {fprintf(stderr, "ERROR: graph has more than %d edges, recompile with -DECL_LARGE_EDGES\n\n", INT_MAX);  exit(-1);}
+  int* const nlist = (int*)malloc(std::max(edges, 1LL) * sizeof(nlist[0]));
+  if (nlist == NULL) {fprintf(stderr, "ERROR: memory allocation failed\n\n");  exit(-1);}
+  #pragma omp parallel for num_threads(threads) default(none) shared(g, nodes, slot, nidx, nlist, lists) schedule(dynamic, 1024)
+  for (int v = 0; v < nodes; v++) {
+    if (slot[v] >= 0) {
+      std::copy(lists[slot[v]].begin(), lists[slot[v]].end(), &nlist[nidx[v]]);
+    } else if (v < g.nodes) {
+      std::copy(&g.nlist[g.nindex[v]], &g.nlist[g.nindex[v + 1]], &nlist[nidx[v]]);
+    }
+  }
+  delete [] slot;
+
+  freeECLgraph(g);
+  g.nodes = nodes;
+  g.edges = edges;
+  g.nindex = nidx;
+  g.nlist = nlist;
+}
+
+
+// lowest color none of v's neighbors has, found with a sliding 32-color window in the posscol bit layout
+inline int firstFitECL(const ECLgraph& g, const int* const color, const int v)
+{
+  for (int base = 0; ; base += 32) {
+    unsigned int used = 0;
+    for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
+      int c;
+      #pragma omp atomic read
+      c = color[g.nlist[i]];
+      if ((c >= base) && (c < base + 32)) used |= 0x80000000u >> (c - base);
+    }
+    if (used != ~0u) return base + __builtin_clz(~used);
+  }
+}
+
+// repairs a coloring that was valid for the first oldnodes vertices of g before the batch was applied to g (see
+// applyECLupdates); color must hold g.nodes entries, the ones of new vertices are ignored. deletions never create
+// conflicts, so only the lower-priority endpoint of each inserted conflicting edge and the new vertices are recolored:
+// all of them pick first-fit colors in parallel, and in every further round only the losers of conflicts with
+// higher-priority neighbors retry, so the work depends on the batch and its neighborhoods rather than on the graph
+// size; returns the number of recolored vertices
+inline int recolorECLgraph(const ECLgraph& g, int* const color, const int oldnodes, const ECLupdate* const upd, const int count, const int threads)
+{
+  std::vector<int> wl;
+  for (int v = oldnodes; v < g.nodes; v++) {
+    color[v] = -1;
+    wl.push_back(v);
+  }
+  for (int k = 0; k < count; k++) {
+    const ECLupdate& u = upd[k];
+    if ((u.type == ECL_INSERT_EDGE) && (u.src != u.dst) && (color[u.src] >= 0) && (color[u.src] == color[u.dst])) {
+      wl.push_back(priorityECL(g.nindex, u.src, u.dst) ? u.dst : u.src);
+    }
+  }
+  std::sort(wl.begin(), wl.end());
+  wl.erase(std::unique(wl.begin(), wl.end()), wl.end());
+  const int recolored = wl.size();
+
+  std::vector<int> wl2(wl.size());
+  int wlsize = wl.size();
+  while (wlsize > 0) {
+    int* const in = wl.data();
+    int* const out = wl2.data();
+    #pragma omp parallel for num_threads(threads) default(none) shared(g, color, in, wlsize)
+    for (int w = 0; w < wlsize; w++) {
+      const int v = in[w];
+      const int c = firstFitECL(g, color, v);
+      #pragma omp atomic write
+      color[v] = c;
+    }
+    int losers = 0;
+    #pragma omp parallel for num_threads(threads) default(none) shared(g, color, in, out, wlsize, losers)
+    for (int w = 0; w < wlsize; w++) {
+      const int v = in[w];
+      for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
+        const int nei = g.nlist[i];
+        if ((color[nei] == color[v]) && priorityECL(g.nindex, nei, v)) {
+          int tmp;
+          #pragma omp atomic capture
+          tmp = losers++;
+          out[tmp] = v;
+          break;
+        }
+      }
+    }
+    wl.swap(wl2);
+    wlsize = losers;
+  }
+  return recolored;
+}
+
+#endif
@@ -1,10 +1,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <vector>
-#include <utility>
 #include <algorithm>
 #include <ctime>
+#include <sys/time.h>
 
 // Comparator function for qsort to sort edges
 int compare_edges(const void* a, const void* b) {
@@ -80,122 +79,32 @@ void save_graph_to_txt(int* edges, int edge_count, const char* filename, int num
     fclose(file);
 }
 
-extern "C" {
-    #include "ECLgraph.h"
-}
+#include <unistd.h>
+#include "ECLbuild.h"
 
 int convert_snap_to_ecl(const char* input_filename, const char* output_filename) {
-    // Record the start time
-    clock_t start_time = clock();
+    // Record the start time (wall clock, the conversion is multithreaded)
+    struct timeval start_time, end_time;
+    gettimeofday(&start_time, NULL);
 
     printf("SNAP to ECL Graph Converter\n");
     printf("Copyright 2016 Texas State University\n");
 
-    FILE* fin = fopen(input_filename, "rt");
-    if (fin == NULL) {
-        fprintf(stderr, "ERROR: could not open input file %s\n\n", input_filename);
-        return -1;
-    }
-
-    char line[256], word1[16], word2[16], word3[16];
-    char* ptr = line;
-    size_t linesize = 256;
-    int cnt;
-    do {
-        cnt = getline(&ptr, &linesize, fin);
-    } while ((cnt > 0) && (strstr(line, "Nodes:") == 0));
-    if (cnt <= 0) {
-        fprintf(stderr, "ERROR: could not find line with node and edge counts\n\n");
-        return -1;
-    }
-    if ((strstr(line, "Nodes:") == 0) || (strstr(line, "Edges:") == 0)) {
-        fprintf(stderr, "ERROR: could not find line with node and edge counts\n\n");
-        return -1;
-    }
-
-    int nodes = -1, edges = -1;
-    cnt = sscanf(line, "%s %s %d %s %d", word1, word2, &nodes, word3, &edges);
-    if ((cnt != 5) || (nodes < 1) || (edges < 0) || (strcmp(word1, "#") != 0) || (strcmp(word2, "Nodes:") != 0) || (strcmp(word3, "Edges:") != 0)) {
-        fprintf(stderr, "ERROR: failed to parse nodes and edge counts\n\n");
-        return -1;
-    }
+    const int threads = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    ECLgraph g = convertECLtext(input_filename, threads);
+    cleanECLgraph(g, threads);
 
     printf("%s\t#name\n", input_filename);
-    printf("%d\t#nodes\n", nodes);
-    printf("%d\t#edges\n", edges);
+    printf("%d\t#nodes\n", g.nodes);
+    printf("%lld\t#edges\n", (long long)g.edges);
     printf("no\t#weights\n");
 
-    while (((cnt = getline(&ptr, &linesize, fin)) > 0) && (strstr(line, "#") != 0)) {}
-    if (cnt < 3) {
-        fprintf(stderr, "ERROR: could not find non-comment line\n\n");
-        return -1;
-    }
-
-    ECLgraph g;
-    g.nodes = nodes;
-    g.edges = edges;
-    g.nindex = (int*)calloc(nodes + 1, sizeof(int));
-    g.nlist = (int*)malloc(edges * sizeof(int));
-    g.eweight = NULL;
-    if ((g.nindex == NULL) || (g.nlist == NULL)) {
-        fprintf(stderr, "ERROR: memory allocation failed\n\n");
-        return -1;
-    }
-
-    int src, dst;
-    std::vector<std::pair<int, int>> v;
-    cnt = 0;
-    if (sscanf(line, "%d %d", &src, &dst) == 2) {
-        cnt++;
-        if ((src < 0) || (src >= nodes)) {
-            fprintf(stderr, "ERROR: source out of range\n\n");
-            return -1;
-        }
-        if ((dst < 0) || (dst >= nodes)) {
-            fprintf(stderr, "ERROR: source out of range\n\n");
-            return -1;
-        }
-        v.push_back(std::make_pair(src, dst));
-    }
-    while (fscanf(fin, "%d %d", &src, &dst) == 2) {
-        cnt++;
-        if ((src < 0) || (src >= nodes)) {
-            fprintf(stderr, "ERROR: source out of range\n\n");
-            return -1;
-        }
-        if ((dst < 0) || (dst >= nodes)) {
-            fprintf(stderr, "ERROR: source out of range\n\n");
-            return -1;
-        }
-        v.push_back(std::make_pair(src, dst));
-    }
-    fclose(fin);
-    if (cnt != edges) {
-        fprintf(stderr, "ERROR: failed to read correct number of edges\n\n");
-        return -1;
-    }
-
-    std::sort(v.begin(), v.end());
-
-    g.nindex[0] = 0;
-    for (int i = 0; i < edges; i++) {
-        int src = v[i].first;
-        int dst = v[i].second;
-        g.nindex[src + 1] = i + 1;
-        g.nlist[i] = dst;
-    }
-
-    for (int i = 1; i < (nodes + 1); i++) {
-        g.nindex[i] = std::max(g.nindex[i - 1], g.nindex[i]);
-    }
-
     writeECLgraph(g, output_filename);
     freeECLgraph(g);
 
-    // Record the end time
-    clock_t end_time = clock();
     // Calculate and print the total time taken
-    double total_time = double(end_time - start_time) / CLOCKS_PER_SEC;
+    gettimeofday(&end_time, NULL);
+    double total_time = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_usec - start_time.tv_usec) / 1e6;
     printf("Total time taken: %.2f seconds\n", total_time);
 
     return 0;
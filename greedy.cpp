@@ -0,0 +1,151 @@
+#include <chrono>
+#include <vector>
+#include "ECLbuild.h"
+
+
+// sequential greedy coloring baseline for ECL-GC on the same CSR input
+
+static const int FIRST_FIT = 0;  // vertices in ID order
+static const int LARGEST_FIRST = 1;  // degree descending
+static const int SMALLEST_LAST = 2;  // reverse of repeatedly removing a vertex of minimum remaining degree
+static const int INCIDENCE_DEGREE = 3;  // next vertex has the most already colored neighbors
+static const int ORDERS = 4;
+static const char* const ordername[ORDERS] = {"first-fit", "largest-first", "smallest-last", "incidence-degree"};
+
+
+// picks the vertex with the largest (INCIDENCE_DEGREE) or smallest (SMALLEST_LAST) key from buckets of stale
+// entries: every key change pushes a new entry and popped entries whose key no longer matches are skipped,
+// so the total work is O(nodes + edges)
+static void bucketOrder(const ECLgraph& g, const int method, const int maxdeg, int* const seq)
+{
+  const int nodes = g.nodes;
+  std::vector<std::vector<int>> bucket(maxdeg + 1);
+  std::vector<int> key(nodes);
+  std::vector<bool> taken(nodes, false);
+  for (int v = nodes - 1; v >= 0; v--) {
+    key[v] = (method == SMALLEST_LAST) ? (g.nindex[v + 1] - g.nindex[v]) : 0;
+    bucket[key[v]].push_back(v);
+  }
+  int cur = 0;
+  for (int k = 0; k < nodes; k++) {
+    int v;
+    do {
+      if (method == SMALLEST_LAST) {
+        while (bucket[cur].empty()) cur++;
+      } else {
+        while (bucket[cur].empty()) cur--;
+      }
+      v = bucket[cur].back();
+      bucket[cur].pop_back();
+    } while (taken[v] || (key[v] != cur));
+    taken[v] = true;
+    seq[(method == SMALLEST_LAST) ? (nodes - 1 - k) : k] = v;
+    for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
+      const int nei = g.nlist[i];
+      if (!taken[nei]) {
+        if (method == SMALLEST_LAST) {
+          key[nei]--;
+          cur = std::min(cur, key[nei]);
+        } else {
+          key[nei]++;
+          cur = std::max(cur, key[nei]);
+        }
+        bucket[key[nei]].push_back(nei);
+      }
+    }
+  }
+}
+
+static void orderVertices(const ECLgraph& g, const int method, const int maxdeg, int* const seq)
+{
+  const int nodes = g.nodes;
+  if (method == FIRST_FIT) {
+    for (int v = 0; v < nodes; v++) seq[v] = v;
+  } else if (method == LARGEST_FIRST) {
+    int* const perm = new int [nodes];
+    orderECLgraph(g, ECL_ORDER_DEGREE, perm, 1);
+    for (int v = 0; v < nodes; v++) seq[perm[v]] = v;
+    delete [] perm;
+  } else {
+    bucketOrder(g, method, maxdeg, seq);
+  }
+}
+
+// colors the vertices in the given sequence with the lowest color none of their colored neighbors has;
+// forbid[c] == stamp marks color c as taken for the current vertex, so it never needs to be cleared and
+// only the first deg(v) + 1 colors are ever examined; returns the number of colors
+static int greedyColor(const ECLgraph& g, const int* const seq, const int maxdeg, int* const color, int* const forbid)
+{
+  const int nodes = g.nodes;
+  for (int v = 0; v < nodes; v++) color[v] = -1;
+  for (int c = 0; c <= maxdeg; c++) forbid[c] = -1;
+  int cols = 0;
+  for (int k = 0; k < nodes; k++) {
+    const int v = seq[k];
+    for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
+      const int c = color[g.nlist[i]];
+      if (c >= 0) forbid[c] = k;
+    }
+    int c = 0;
+    while (forbid[c] == k) c++;
+    color[v] = c;
+    cols = std::max(cols, c + 1);
+  }
+  return cols;
+}
+
+
+int main(int argc, char* argv[])
+{
+  printf("Sequential Greedy Graph Coloring (%s)\n\n", __FILE__);
+
+  if (argc < 2) {printf("USAGE: %s input_file_name [first-fit|largest-first|smallest-last|incidence-degree|all] [--mmap]\n\n", argv[0]);  exit(-1);}
+  bool mapped = false;
+  int order = FIRST_FIT;
+  bool all = false;
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--mmap") == 0) {
+      mapped = true;
+    } else if (strcmp(argv[i], "all") == 0) {
+      all = true;
+    } else {
+      order = -1;
+      for (int k = 0; k < ORDERS; k++) {
+        if (strcmp(argv[i], ordername[k]) == 0) order = k;
+      }
+      if (order < 0) {fprintf(stderr, "ERROR: unknown option %s\n", argv[i]);  exit(-1);}
+    }
+  }
+
+  ECLgraph g = mapped ? mapECLgraph(argv[1]) : readECLgraph(argv[1]);
+  printf("input: %s\n", argv[1]);
+  printf("nodes: %d\n", g.nodes);
+  printf("edges: %lld\n", (long long)g.edges);
+  int maxdeg = 0;
+  for (int v = 0; v < g.nodes; v++) maxdeg = std::max(maxdeg, (int)(g.nindex[v + 1] - g.nindex[v]));
+  printf("max degree: %d\n", maxdeg);
+
+  int* const seq = new int [g.nodes];
+  int* const color = new int [g.nodes];
+  int* const forbid = new int [maxdeg + 1];
+  for (int k = (all ? 0 : order); k < (all ? ORDERS : (order + 1)); k++) {
+    const std::chrono::steady_clock::time_point beg = std::chrono::steady_clock::now();
+    orderVertices(g, k, maxdeg, seq);
+    const std::chrono::steady_clock::time_point mid = std::chrono::steady_clock::now();
+    const int cols = greedyColor(g, seq, maxdeg, color, forbid);
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    for (int v = 0; v < g.nodes; v++) {
+      for (ECLedge i = g.nindex[v]; i < g.nindex[v + 1]; i++) {
+        if ((g.nlist[i] != v) && (color[g.nlist[i]] == color[v])) {printf("ERROR: found adjacent nodes with same color %d (%d %d)\n\n", color[v], v, g.nlist[i]);  exit(-1);}
+      }
+    }
+    printf("%s: %d colors, order time %.6f s, color time %.6f s, total %.6f s\n", ordername[k], cols, std::chrono::duration<double>(mid - beg).count(), std::chrono::duration<double>(end - mid).count(), std::chrono::duration<double>(end - beg).count());
+  }
+
+  delete [] seq;
+  delete [] color;
+  delete [] forbid;
+  freeECLgraph(g);
+  return 0;
+}
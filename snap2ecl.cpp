@@ -0,0 +1,45 @@
+#include <chrono>
+#include <unistd.h>
+#include "ECLbuild.h"
+
+
+int main(int argc, char* argv[])
+{
+  printf("SNAP/MatrixMarket to ECL Graph Converter (%s)\n", __FILE__);
+  printf("Copyright 2016 Texas State University\n\n");
+
+  if ((argc < 3) || (argc > 5)) {printf("USAGE: %s input_file_name output_file_name [thread_count] [--raw]\n\n", argv[0]);  exit(-1);}
+  int threads = std::max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+  bool raw = false;  // keep the edges as given instead of producing an undirected simple graph
+  for (int i = 3; i < argc; i++) {
+    if (strcmp(argv[i], "--raw") == 0) {
+      raw = true;
+    } else {
+      threads = atoi(argv[i]);
+      if (threads < 1) {fprintf(stderr, "ERROR: thread_count must be at least 1\n");  exit(-1);}
+    }
+  }
+
+  const std::chrono::steady_clock::time_point beg = std::chrono::steady_clock::now();
+  ECLgraph g = convertECLtext(argv[1], threads);
+  const ECLedge parsed = g.edges;
+  const std::chrono::steady_clock::time_point conv = std::chrono::steady_clock::now();
+  long long loops = 0;
+  if (!raw) loops = cleanECLgraph(g, threads);
+  const std::chrono::steady_clock::time_point mid = std::chrono::steady_clock::now();
+  writeECLgraph(g, argv[2]);
+  const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+  printf("%s\t#name\n", argv[1]);
+  printf("%d\t#nodes\n", g.nodes);
+  printf("%lld\t#edges\n", (long long)g.edges);
+  printf("no\t#weights\n");
+  printf("%d\t#threads\n", threads);
+  if (!raw) printf("%lld\t#parsed edges (%lld self-loops dropped)\n", (long long)parsed, loops);
+  printf("convert time: %.6f s\n", std::chrono::duration<double>(conv - beg).count());
+  if (!raw) printf("clean time:   %.6f s\n", std::chrono::duration<double>(mid - conv).count());
+  printf("write time:   %.6f s\n", std::chrono::duration<double>(end - mid).count());
+
+  freeECLgraph(g);
+  return 0;
+}